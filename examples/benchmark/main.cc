@@ -15,12 +15,22 @@
 
 #define CHRONO_ALWAYS_ON
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
 #include <numeric>
 #include <random>
 #include <string>
 #include <thread>
+#include <utility>
 
 #include "base/chrono.h"
 #include "base/face.h"
@@ -32,6 +42,8 @@
 #include "face/options.h"
 #include "sdk/clova_see.h"
 #include "sdk/measure_result.h"
+#include "session_pool.h"
+#include "stream_executor.h"
 #include "test/image.h"
 #include "test/people_search.h"
 #include "third_parties/fmt/include/fmt/format.h"
@@ -46,10 +58,22 @@
   #include <dirent.h>
 #endif  // USE_STD_FILESYSTEM
 
+#if defined(__linux__)
+  #include <sched.h>
+  #include <unistd.h>
+#endif  // defined(__linux__)
+
+#if defined(__GLIBC__)
+  #include <malloc.h>
+#endif  // defined(__GLIBC__)
+
 namespace {
 
 using PerformanceMode = clova::Settings::PerformanceMode;
 
+// Bit N stands for the N-th logical core.
+using CpuMask = uint64_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // class BenchmarkImageDispenser
 
@@ -141,6 +165,243 @@ clova::Paths GetBenchmarkImagePaths(const clova::Path& directory) {
 
 #endif  // USE_STD_FILESYSTEM
 
+////////////////////////////////////////////////////////////////////////////////
+// Memory
+
+// Counted by the replaced global operator new below the anonymous namespace,
+// only while |is_counting_allocations|, so that the other benchmarks do not
+// contend on the counters.
+std::atomic<bool> is_counting_allocations { false };
+std::atomic<size_t> allocation_count { 0 };
+std::atomic<size_t> allocated_bytes { 0 };
+
+#if defined(__linux__)
+
+size_t GetResidentMemoryInBytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  statm >> total_pages >> resident_pages;
+  return resident_pages * sysconf(_SC_PAGESIZE);
+}
+
+// Returns VmHWM, the high water mark of the resident memory.
+size_t GetPeakResidentMemoryInBytes() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      size_t peak_in_kilo_bytes = 0;
+      status >> peak_in_kilo_bytes;
+      return peak_in_kilo_bytes * 1024;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return 0;
+}
+
+// Brings VmHWM down to the current resident memory.
+void ResetPeakResidentMemory() {
+  std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+#else
+
+size_t GetResidentMemoryInBytes() {
+  return 0;
+}
+
+size_t GetPeakResidentMemoryInBytes() {
+  return 0;
+}
+
+void ResetPeakResidentMemory() {
+}
+
+#endif  // defined(__linux__)
+
+// Returns the resident memory to measure the growth of a measurement from.
+// The heap memory freed by the earlier measurements is handed back to the
+// system first, or the allocator would reuse it and hide the growth. VmHWM is
+// brought down to the baseline as well.
+size_t ResetMemoryBaseline() {
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif  // defined(__GLIBC__)
+  ResetPeakResidentMemory();
+  return GetResidentMemoryInBytes();
+}
+
+float ToMegaBytes(size_t bytes) {
+  return bytes / (1024.0f * 1024.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// CPU Affinity
+
+size_t GetNumberOfCores() {
+  return std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                          sizeof(CpuMask) * 8);
+}
+
+CpuMask GetAllCores() {
+  const size_t number_of_cores = GetNumberOfCores();
+  if (number_of_cores == sizeof(CpuMask) * 8)
+    return ~CpuMask(0);
+  return (CpuMask(1) << number_of_cores) - 1;
+}
+
+#if defined(__linux__)
+
+// Returns the cores with the highest cpu_capacity, i.e. the big cores of a
+// big.LITTLE system. Falls back to all cores when the kernel does not expose
+// the capacities.
+CpuMask GetBigCores() {
+  std::vector<int> capacities;
+  for (size_t core = 0; core < GetNumberOfCores(); ++core) {
+    std::ifstream file(fmt::format(
+        "/sys/devices/system/cpu/cpu{}/cpu_capacity", core));
+    int capacity = 0;
+    if (!(file >> capacity))
+      return GetAllCores();
+    capacities.push_back(capacity);
+  }
+
+  const int maximum_capacity =
+      *std::max_element(capacities.cbegin(), capacities.cend());
+  CpuMask cpu_mask = 0;
+  for (size_t core = 0; core < capacities.size(); ++core) {
+    if (capacities[core] == maximum_capacity)
+      cpu_mask |= CpuMask(1) << core;
+  }
+  return cpu_mask;
+}
+
+CpuMask GetCpuAffinity() {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+    return GetAllCores();
+
+  CpuMask cpu_mask = 0;
+  for (size_t core = 0; core < GetNumberOfCores(); ++core) {
+    if (CPU_ISSET(core, &cpu_set))
+      cpu_mask |= CpuMask(1) << core;
+  }
+  return cpu_mask;
+}
+
+// Pins the calling thread to |cpu_mask|. Threads created afterwards, such as
+// the workers of a ClovaSee constructed on this thread, inherit the affinity.
+bool SetCpuAffinity(CpuMask cpu_mask) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (size_t core = 0; core < GetNumberOfCores(); ++core) {
+    if (cpu_mask & (CpuMask(1) << core))
+      CPU_SET(core, &cpu_set);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+}
+
+#else
+
+CpuMask GetBigCores() {
+  return GetAllCores();
+}
+
+CpuMask GetCpuAffinity() {
+  return GetAllCores();
+}
+
+bool SetCpuAffinity(CpuMask cpu_mask) {
+  return false;
+}
+
+#endif  // defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////
+// class ScopedCpuAffinity
+
+// Pins the calling thread to |cpu_mask| for its scope. Nothing is pinned when
+// |cpu_mask| is already the affinity of the thread.
+class ScopedCpuAffinity {
+ public:
+  explicit ScopedCpuAffinity(CpuMask cpu_mask);
+  virtual ~ScopedCpuAffinity();
+
+ private:
+  const CpuMask previous_cpu_mask_;
+  bool is_pinned_;
+};
+
+ScopedCpuAffinity::ScopedCpuAffinity(CpuMask cpu_mask)
+    : previous_cpu_mask_(GetCpuAffinity()),
+      is_pinned_(false) {
+  if (cpu_mask == previous_cpu_mask_)
+    return;
+
+  is_pinned_ = SetCpuAffinity(cpu_mask);
+  if (!is_pinned_)
+    std::cerr << "Failed to set the CPU affinity." << std::endl;
+}
+
+ScopedCpuAffinity::~ScopedCpuAffinity() {
+  if (is_pinned_)
+    SetCpuAffinity(previous_cpu_mask_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class FeatureProjector
+
+// Projects features onto fewer dimensions with a fixed random Gaussian matrix,
+// which preserves their cosine similarities approximately, so that a gallery
+// takes a fraction of the memory and the matching time.
+class FeatureProjector {
+ public:
+  FeatureProjector(size_t input_dimension, size_t output_dimension);
+  virtual ~FeatureProjector();
+
+  // Returns the L2-normalized projection of |feature|.
+  clova::Feature Project(const clova::Feature& feature) const;
+
+ private:
+  const size_t input_dimension_;
+  const size_t output_dimension_;
+  std::vector<float> matrix_;
+};
+
+FeatureProjector::FeatureProjector(size_t input_dimension,
+                                   size_t output_dimension)
+    : input_dimension_(input_dimension),
+      output_dimension_(output_dimension),
+      matrix_(input_dimension * output_dimension) {
+  std::mt19937 randomizer(0);
+  std::normal_distribution<float> distributor;
+  for (auto& element : matrix_)
+    element = distributor(randomizer);
+}
+
+FeatureProjector::~FeatureProjector() {
+}
+
+clova::Feature FeatureProjector::Project(const clova::Feature& feature) const {
+  assert(feature.size() == input_dimension_);
+  clova::Feature projection(output_dimension_, 0.0f);
+  for (size_t row = 0; row < output_dimension_; ++row) {
+    const float* weights = &matrix_[row * input_dimension_];
+    projection[row] = std::inner_product(feature.cbegin(), feature.cend(),
+                                         weights, 0.0f);
+  }
+
+  const float norm = std::sqrt(std::inner_product(
+      projection.cbegin(), projection.cend(), projection.cbegin(), 0.0f));
+  if (norm > 0.0f) {
+    for (auto& element : projection)
+      element /= norm;
+  }
+  return projection;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Common
 
@@ -150,6 +411,24 @@ const std::vector<std::string> kTableColumnLabels {
   "FPS", "Total", "D", "L", "A", "E", "R", "MD", "SD"
 };
 
+const std::vector<std::pair<std::string, float clova::MeasureResult::*>>
+kStageColumns {
+  { "D", &clova::MeasureResult::detector_in_milli },
+  { "L", &clova::MeasureResult::landmarker_in_milli },
+  { "A", &clova::MeasureResult::aligner_in_milli },
+  { "E", &clova::MeasureResult::estimator_in_milli },
+  { "R", &clova::MeasureResult::recognizer_in_milli },
+  { "MD", &clova::MeasureResult::mask_detector_in_milli },
+  { "SD", &clova::MeasureResult::spoofing_detector_in_milli },
+};
+
+// A stage is considered saturated once more threads bring it no closer than
+// this ratio to its best latency.
+constexpr float kThreadScalingTolerance = 1.1f;
+
+// Average MeasureResults per number of threads, for one performance mode.
+using ThreadScaling = std::map<int, clova::MeasureResult>;
+
 std::string ToString(const PerformanceMode& performance_mode) {
   switch (performance_mode) {
     case PerformanceMode::kAccurate106:
@@ -167,11 +446,15 @@ void PrintTableDivider() {
   fmt::print("{:─^{}}\n", "", kTableColumnLabels.size() * kTableColumnWidth);
 }
 
-void PrintPreamble(const clova::Settings& settings) {
+void PrintPreamble(const clova::Settings& settings,
+                   CpuMask cpu_mask,
+                   size_t warm_up_count) {
   std::vector<std::string> contents {
+    fmt::format(" cpu affinity      : {:#x} ", cpu_mask),
     fmt::format(" number of threads : {} ", settings.number_of_threads),
     fmt::format(" performance mode  : {} ",
                 ToString(settings.performance_mode)),
+    fmt::format(" warm-up runs      : {} ", warm_up_count),
   };
   const auto& maximum_length =
       ranges::max_element(contents, std::less<>(), &std::string::size)->size();
@@ -219,15 +502,53 @@ void PrintTableRow(const clova::MeasureResult& result) {
   fmt::print("{}\n", row);
 }
 
-void PrintTableFooter(const std::vector<clova::MeasureResult>& results) {
-  auto average = std::accumulate(results.cbegin(),
-                                 results.cend(),
-                                 clova::MeasureResult())
-               / results.size();
+clova::MeasureResult Average(const std::vector<clova::MeasureResult>& results) {
+  if (results.empty())
+    return clova::MeasureResult();
+  return std::accumulate(results.cbegin(),
+                         results.cend(),
+                         clova::MeasureResult())
+       / results.size();
+}
+
+void PrintTableFooter(const clova::MeasureResult& average) {
   PrintTableRow(average);
   std::cout << std::endl;
 }
 
+// Prints the latency of every stage for each number of threads, along with
+// the smallest number of threads that brings the stage within
+// kThreadScalingTolerance of its best latency. Stages that barely scale end up
+// with a small budget, leaving the cores to the ones that do.
+void PrintThreadScaling(const PerformanceMode& performance_mode,
+                        const ThreadScaling& thread_scaling) {
+  fmt::print("Thread scaling ({})\n", ToString(performance_mode));
+  fmt::print("{: >{}}", "Stage", kTableColumnWidth);
+  for (const auto& pair : thread_scaling)
+    fmt::print("{: >{}}", fmt::format("{}T", pair.first), kTableColumnWidth);
+  fmt::print("{: >{}}\n", "Budget", kTableColumnWidth);
+
+  for (const auto& stage : kStageColumns) {
+    float best_in_milli = std::numeric_limits<float>::max();
+    for (const auto& pair : thread_scaling)
+      best_in_milli = std::min(best_in_milli, pair.second.*stage.second);
+
+    int budget = 0;
+    fmt::print("{: >{}}", stage.first, kTableColumnWidth);
+    for (const auto& pair : thread_scaling) {
+      const float latency_in_milli = pair.second.*stage.second;
+      if (budget == 0 &&
+          latency_in_milli <= best_in_milli * kThreadScalingTolerance) {
+        budget = pair.first;
+      }
+      fmt::print("{: >{}}", fmt::format("{:.2f}ms", latency_in_milli),
+                 kTableColumnWidth);
+    }
+    fmt::print("{: >{}}\n", budget, kTableColumnWidth);
+  }
+  std::cout << std::endl;
+}
+
 clova::Settings NewSettings(int number_of_threads,
                             const PerformanceMode& performance_mode) {
   return clova::SettingsBuilder()
@@ -237,29 +558,78 @@ clova::Settings NewSettings(int number_of_threads,
       .Build();
 }
 
-void DoBenchmark(const BenchmarkImageDispenser& dispenser,
-                 size_t repeat_count,
-                 size_t logging_step,
-                 const clova::Settings& settings = clova::Settings()) {
+clova::face::Options NewOptions() {
+  return clova::face::OptionsBuilder()
+      .SetBoundingBoxThreshold(0.7f)
+      .SetInformationToObtain(clova::face::Options::kAll)
+      .SetResizeThreshold(320)
+      .SetSmoothingContour(true)
+      .SetSmoothingRect(false)
+      .Build();
+}
+
+// Runs |clova_see| in windows of a few frames until the mean latency stops
+// improving, so that every stage enabled by |options| has allocated its
+// buffers before measuring. Returns the number of runs it took.
+size_t WarmUp(clova::ClovaSee& clova_see,
+              const BenchmarkImageDispenser& dispenser,
+              const clova::face::Options& options) {
+  constexpr size_t kWindowSize = 5;
+  constexpr size_t kMaximumWindowCount = 20;
+  constexpr float kConvergenceRatio = 0.05f;
+
+  float previous_window_in_milli = std::numeric_limits<float>::max();
+  for (size_t window = 0; window < kMaximumWindowCount; ++window) {
+    float window_in_milli = 0.0f;
+    for (size_t count = 0; count < kWindowSize; ++count) {
+      clova_see.Run(dispenser.RandomNext().frame(), options);
+      window_in_milli += 1000.0f / clova_see.GetMeasureResult().total_fps;
+    }
+    window_in_milli /= kWindowSize;
+
+    const float improvement_in_milli =
+        previous_window_in_milli - window_in_milli;
+    if (improvement_in_milli < previous_window_in_milli * kConvergenceRatio)
+      return (window + 1) * kWindowSize;
+    previous_window_in_milli = window_in_milli;
+  }
+  return kMaximumWindowCount * kWindowSize;
+}
+
+// Options without tracking or smoothing, whose results do not depend on the
+// frames an instance has seen before.
+clova::face::Options NewStatelessOptions() {
+  using Options = clova::face::Options;
+  return clova::face::OptionsBuilder()
+      .SetBoundingBoxThreshold(0.7f)
+      .SetInformationToObtain(Options::kAll & ~Options::kTrackingIDs)
+      .SetResizeThreshold(320)
+      .SetSmoothingContour(false)
+      .SetSmoothingRect(false)
+      .Build();
+}
+
+clova::MeasureResult DoBenchmark(const BenchmarkImageDispenser& dispenser,
+                                size_t repeat_count,
+                                size_t logging_step,
+                                const clova::Settings& settings =
+                                    clova::Settings(),
+                                CpuMask cpu_mask = GetCpuAffinity()) {
   const bool do_logging = logging_step != 0;
+  ScopedCpuAffinity scoped_cpu_affinity(cpu_mask);
   clova::ClovaSee clova_see(settings);
   clova::MeasureResult measure_result;
   std::vector<clova::MeasureResult> measure_results;
 
+  const auto& options = NewOptions();
+  const size_t warm_up_count = WarmUp(clova_see, dispenser, options);
+
   if (do_logging) {
-    PrintPreamble(settings);
+    PrintPreamble(settings, cpu_mask, warm_up_count);
     PrintTableHeader();
     PrintTableDivider();
   }
 
-  const auto& options = clova::face::OptionsBuilder()
-      .SetBoundingBoxThreshold(0.7f)
-      .SetInformationToObtain(clova::face::Options::kAll)
-      .SetResizeThreshold(320)
-      .SetSmoothingContour(true)
-      .SetSmoothingRect(false)
-      .Build();
-
   for (size_t count = 0; count < repeat_count; ++count) {
     clova_see.Run(dispenser.RandomNext().frame(), options);
     measure_result += clova_see.GetMeasureResult();
@@ -271,20 +641,12 @@ void DoBenchmark(const BenchmarkImageDispenser& dispenser,
     }
   }
 
+  const auto& average = Average(measure_results);
   if (do_logging) {
     PrintTableDivider();
-    PrintTableFooter(measure_results);
-    measure_results.clear();
-  }
-}
-
-void DoWarmUp(const BenchmarkImageDispenser& dispenser) {
-  std::cout << "Warming Up" << std::flush;
-  for (size_t count = 0; count < 10; ++count) {
-    DoBenchmark(dispenser, 10, 0);
-    std::cout << "." << std::flush;
+    PrintTableFooter(average);
   }
-  std::cout << std::endl << std::endl;
+  return average;
 }
 
 void DoCoolDown() {
@@ -296,6 +658,700 @@ void DoCoolDown() {
   std::cout << std::endl << std::endl;
 }
 
+// Compares running unpinned against running pinned to the big cores only. On
+// machines without big.LITTLE, or when the process is already restricted to
+// the big cores, both masks are the same and this is a no-op.
+void DoCpuAffinityBenchmark(const BenchmarkImageDispenser& dispenser) {
+  const CpuMask big_cores = GetBigCores();
+  if (big_cores == GetCpuAffinity())
+    return;
+
+  for (const auto& number_of_threads: { 1, 2, 4 }) {
+    DoBenchmark(dispenser,
+                100,  // repeat_count
+                10,   // logging_step
+                NewSettings(number_of_threads, PerformanceMode::kAccurate106),
+                big_cores);
+    DoCoolDown();
+  }
+}
+
+// Decodes |count| images up front, so that concurrent streams can share them
+// without touching the dispenser, which is not thread-safe.
+std::vector<clova::test::Image> PreloadImages(
+    const BenchmarkImageDispenser& dispenser, size_t count) {
+  std::vector<clova::test::Image> images;
+  for (size_t index = 0; index < count; ++index)
+    images.push_back(dispenser.RandomNext());
+  return images;
+}
+
+// Runs |frame_count| frames on each of |stream_count| streams through
+// |executor| and blocks until all of them are done. A stream of weight N runs
+// N frames each time it is scheduled, and frames of the same stream never run
+// concurrently.
+void RunStreams(benchmark::StreamExecutor& executor,
+                size_t stream_count,
+                size_t frame_count,
+                size_t weight,
+                const std::function<void(size_t, size_t)>& run_frame) {
+  std::vector<size_t> frame_indices(stream_count, 0);
+  std::function<void(size_t)> run_stream;
+  const auto& schedule_stream = [&](size_t stream_id) {
+    executor.Submit(stream_id, [&, stream_id]() { run_stream(stream_id); });
+  };
+  run_stream = [&](size_t stream_id) {
+    auto& frame_index = frame_indices[stream_id];
+    for (size_t count = 0;
+         count < weight && frame_index < frame_count;
+         ++count, ++frame_index) {
+      run_frame(stream_id, frame_index);
+    }
+    if (frame_index < frame_count)
+      schedule_stream(stream_id);
+  };
+  for (size_t stream_id = 0; stream_id < stream_count; ++stream_id)
+    schedule_stream(stream_id);
+  executor.Wait();
+}
+
+// Runs |stream_count| streams of |frame_count| frames each with one ClovaSee
+// per stream, first on a private pool of |number_of_threads| per instance and
+// then with single-threaded instances on one StreamExecutor sized to the
+// cores. A stream of weight N runs N frames each time it is scheduled.
+void DoMultiStreamBenchmark(const BenchmarkImageDispenser& dispenser,
+                            int number_of_threads) {
+  constexpr size_t kFrameCount = 50;
+  constexpr size_t kStreamWeight = 1;
+  const auto& images = PreloadImages(dispenser, 10);
+  const auto& options = NewOptions();
+
+  for (const size_t stream_count : { 2, 4, 8 }) {
+    const auto& new_instances = [&](int threads_per_instance) {
+      std::vector<std::unique_ptr<clova::ClovaSee>> instances;
+      for (size_t stream_id = 0; stream_id < stream_count; ++stream_id) {
+        instances.push_back(std::make_unique<clova::ClovaSee>(
+            NewSettings(threads_per_instance, PerformanceMode::kAccurate106)));
+      }
+      return instances;
+    };
+
+    float dedicated_in_milli = 0.0f;
+    auto instances = new_instances(number_of_threads);
+    using namespace clova;
+    measure_in_milli(dedicated_in_milli) {
+      std::vector<std::thread> streams;
+      for (size_t stream_id = 0; stream_id < stream_count; ++stream_id) {
+        streams.emplace_back([&, stream_id]() {
+          for (size_t count = 0; count < kFrameCount; ++count) {
+            const auto& image = images[(stream_id + count) % images.size()];
+            instances[stream_id]->Run(image.frame(), options);
+          }
+        });
+      }
+      for (auto& stream : streams)
+        stream.join();
+    }
+
+    float shared_in_milli = 0.0f;
+    benchmark::StreamExecutor executor(GetNumberOfCores());
+    instances = new_instances(1);
+    measure_in_milli(shared_in_milli) {
+      RunStreams(executor, stream_count, kFrameCount, kStreamWeight,
+                 [&](size_t stream_id, size_t frame_index) {
+        const auto& image = images[(stream_id + frame_index) % images.size()];
+        instances[stream_id]->Run(image.frame(), options);
+      });
+    }
+
+    const auto& to_fps = [&](float elapsed_in_milli) {
+      return stream_count * kFrameCount * 1000.0f / elapsed_in_milli;
+    };
+    fmt::print("Streams {}: {:>3} threads {:>8.2f}fps, "
+               "{:>3} threads (shared) {:>8.2f}fps\n",
+               stream_count,
+               stream_count * number_of_threads,
+               to_fps(dedicated_in_milli),
+               executor.number_of_workers(),
+               to_fps(shared_in_milli));
+  }
+  std::cout << std::endl;
+}
+
+// Serves many streams from one SessionPool whose shared instances match the
+// number of cores, and reports the throughput along with how many instances,
+// and how much resident memory, it took. The first stream tracks faces and
+// thus keeps a stateful session of its own.
+void DoSessionBenchmark(const BenchmarkImageDispenser& dispenser) {
+  constexpr size_t kFrameCount = 20;
+  const auto& images = PreloadImages(dispenser, 10);
+  const auto& stateful_options = NewOptions();
+  const auto& stateless_options = NewStatelessOptions();
+
+  for (const size_t stream_count : { 4, 8, 16 }) {
+    const size_t baseline_in_bytes = ResetMemoryBaseline();
+    benchmark::StreamExecutor executor(GetNumberOfCores());
+    benchmark::SessionPool session_pool(
+        NewSettings(1, PerformanceMode::kAccurate106),
+        executor.number_of_workers());
+    std::vector<std::unique_ptr<benchmark::SessionPool::Session>> sessions;
+    for (size_t stream_id = 0; stream_id < stream_count; ++stream_id)
+      sessions.push_back(session_pool.CreateSession(stream_id == 0));
+
+    float elapsed_in_milli = 0.0f;
+    using namespace clova;
+    measure_in_milli(elapsed_in_milli) {
+      RunStreams(executor, stream_count, kFrameCount, 1,
+                 [&](size_t stream_id, size_t frame_index) {
+        const auto& image = images[(stream_id + frame_index) % images.size()];
+        auto& session = *sessions[stream_id];
+        session_pool.Run(session, image.frame(),
+                         session.is_stateful() ? stateful_options
+                                               : stateless_options);
+      });
+    }
+
+    const size_t resident_in_bytes =
+        std::max(GetResidentMemoryInBytes(), baseline_in_bytes)
+        - baseline_in_bytes;
+    const size_t number_of_instances = session_pool.number_of_instances();
+    sessions.front().reset();
+    fmt::print("Sessions {:>2}: {:>2} instances ({:>2} after closing the "
+               "stateful one) {:>8.2f}fps, {:>8.2f}MB resident\n",
+               stream_count,
+               number_of_instances,
+               session_pool.number_of_instances(),
+               stream_count * kFrameCount * 1000.0f / elapsed_in_milli,
+               ToMegaBytes(resident_in_bytes));
+  }
+  std::cout << std::endl;
+}
+
+// Returns whether |faces| has exactly |expected_boxes|, in the same order.
+bool HasBoundingBoxes(const std::vector<clova::Face>& faces,
+                      const std::vector<clova::Rect>& expected_boxes) {
+  return std::equal(
+      faces.cbegin(), faces.cend(),
+      expected_boxes.cbegin(), expected_boxes.cend(),
+      [](const clova::Face& face, const clova::Rect& expected_box) {
+        const auto& box = face.bounding_box();
+        return box.x() == expected_box.x() && box.y() == expected_box.y() &&
+               box.width() == expected_box.width() &&
+               box.height() == expected_box.height();
+      });
+}
+
+// Calls Run concurrently from a growing number of caller threads, like the
+// workers of an HTTP server, on stateless sessions of one SessionPool. Each
+// concurrent Run holds a ClovaSee instance of the pool to itself, and every
+// instance loads its own models and runs its own threads.
+// Every result has to have the bounding boxes of a single-threaded reference
+// run of the same image, and the throughput is reported relative to a single
+// caller.
+void DoConcurrentRunBenchmark(const BenchmarkImageDispenser& dispenser) {
+  constexpr size_t kRequestCount = 20;
+  const auto& images = PreloadImages(dispenser, 10);
+  const auto& options = NewStatelessOptions();
+  const auto& settings = NewSettings(1, PerformanceMode::kAccurate106);
+
+  benchmark::SessionPool session_pool(settings, GetNumberOfCores());
+  std::vector<std::vector<clova::Rect>> expected_boxes;
+  {
+    clova::ClovaSee clova_see(settings);
+    for (const auto& image : images) {
+      expected_boxes.emplace_back();
+      for (const auto& face : clova_see.Run(image.frame(), options).faces())
+        expected_boxes.back().push_back(face.bounding_box());
+    }
+  }
+
+  float single_caller_fps = 0.0f;
+  for (const size_t caller_count : { 1, 2, 4, 8 }) {
+    std::atomic<size_t> mismatch_count(0);
+    float elapsed_in_milli = 0.0f;
+    using namespace clova;
+    measure_in_milli(elapsed_in_milli) {
+      std::vector<std::thread> callers;
+      for (size_t caller_id = 0; caller_id < caller_count; ++caller_id) {
+        callers.emplace_back([&, caller_id]() {
+          const auto& session = session_pool.CreateSession(false);
+          for (size_t count = 0; count < kRequestCount; ++count) {
+            const size_t index = (caller_id + count) % images.size();
+            const auto& result =
+                session_pool.Run(*session, images[index].frame(), options);
+            if (!HasBoundingBoxes(result.faces(), expected_boxes[index]))
+              ++mismatch_count;
+          }
+        });
+      }
+      for (auto& caller : callers)
+        caller.join();
+    }
+
+    const float fps = caller_count * kRequestCount * 1000.0f / elapsed_in_milli;
+    if (caller_count == 1)
+      single_caller_fps = fps;
+    fmt::print("Callers {}: {:>8.2f}fps, {:>5.2f}x, {} mismatches\n",
+               caller_count,
+               fps,
+               fps / single_caller_fps,
+               mismatch_count.load());
+  }
+  std::cout << std::endl;
+}
+
+// Runs every image of |images| through a fresh ClovaSee built from |settings|,
+// once it is warmed up, and returns the largest face of each, if any, along
+// with the mean latency.
+std::vector<std::vector<clova::Face>> GetLargestFaces(
+    const BenchmarkImageDispenser& dispenser,
+    const std::vector<clova::test::Image>& images,
+    const clova::Settings& settings,
+    float& latency_in_milli) {
+  clova::ClovaSee clova_see(settings);
+  const auto& options = NewStatelessOptions();
+  WarmUp(clova_see, dispenser, options);
+
+  std::vector<std::vector<clova::Face>> largest_faces;
+  latency_in_milli = 0.0f;
+  for (const auto& image : images) {
+    const auto& result = clova_see.Run(image.frame(), options);
+    latency_in_milli += 1000.0f / clova_see.GetMeasureResult().total_fps;
+
+    const auto& faces = result.faces();
+    const auto& largest_face = std::max_element(
+        faces.cbegin(), faces.cend(),
+        [](const clova::Face& lhs, const clova::Face& rhs) {
+          return lhs.bounding_box().width() < rhs.bounding_box().width();
+        });
+    largest_faces.emplace_back();
+    if (largest_face != faces.cend())
+      largest_faces.back().push_back(*largest_face);
+  }
+  latency_in_milli /= std::max<size_t>(images.size(), 1);
+  return largest_faces;
+}
+
+// Reports, per performance mode, the latency of a Run next to how far its
+// embeddings drift from those of kAccurate106 on the same images, as the mean
+// and the worst cosine similarity. Any reduced-precision mode has to be
+// judged on both.
+void DoEmbeddingDriftBenchmark(const BenchmarkImageDispenser& dispenser) {
+  const auto& images = PreloadImages(dispenser, 20);
+  float reference_latency_in_milli = 0.0f;
+  const auto& reference_faces = GetLargestFaces(
+      dispenser, images, NewSettings(1, PerformanceMode::kAccurate106),
+      reference_latency_in_milli);
+
+  for (const auto& performance_mode : { PerformanceMode::kAccurate106,
+                                        PerformanceMode::kAccurate98,
+                                        PerformanceMode::kFast }) {
+    float latency_in_milli = 0.0f;
+    const auto& faces = GetLargestFaces(
+        dispenser, images, NewSettings(1, performance_mode), latency_in_milli);
+
+    std::vector<float> similarities;
+    for (size_t index = 0; index < images.size(); ++index) {
+      if (faces[index].empty() || reference_faces[index].empty())
+        continue;
+      similarities.push_back(clova::Face::GetCosineSimilarity(
+          faces[index].front(), reference_faces[index].front()));
+    }
+    if (similarities.empty())
+      continue;
+
+    fmt::print("{:>12}: {:>8.2f}ms ({:>5.2f}x), cosine mean {:.4f}, "
+               "min {:.4f}\n",
+               ToString(performance_mode),
+               latency_in_milli,
+               reference_latency_in_milli / latency_in_milli,
+               std::accumulate(similarities.cbegin(), similarities.cend(),
+                               0.0f) / similarities.size(),
+               *std::min_element(similarities.cbegin(), similarities.cend()));
+  }
+  std::cout << std::endl;
+}
+
+float GetIntersectionOverUnion(const clova::Rect& lhs, const clova::Rect& rhs) {
+  const int width =
+      std::min(lhs.x() + lhs.width(), rhs.x() + rhs.width()) -
+      std::max(lhs.x(), rhs.x());
+  const int height =
+      std::min(lhs.y() + lhs.height(), rhs.y() + rhs.height()) -
+      std::max(lhs.y(), rhs.y());
+  if (width <= 0 || height <= 0)
+    return 0.0f;
+  const float intersection = static_cast<float>(width) * height;
+  return intersection / (lhs.width() * lhs.height() +
+                         rhs.width() * rhs.height() - intersection);
+}
+
+// Validates a detector input derived from the minimum face size: the smallest
+// resize threshold, aligned to 32, at which a face of kMinimumBoundingBoxSize
+// still spans the smallest anchor of the detector, 16 pixels. Every threshold
+// down to it is timed, and its recall is counted against 320 on the faces of
+// at least the minimum size, matched by an IoU of 0.5. The HighGui example
+// stays at 320 until this reports no lost faces.
+void DoResizeThresholdBenchmark(const BenchmarkImageDispenser& dispenser) {
+  constexpr int kReferenceResizeThreshold = 320;
+  constexpr int kResizeThresholdAlignment = 32;
+  constexpr int kSmallestAnchorInPixels = 16;
+  constexpr float kMinimumBoundingBoxSize = 0.1f;
+  constexpr float kMinimumIntersectionOverUnion = 0.5f;
+  const int derived_resize_threshold =
+      (static_cast<int>(std::ceil(kSmallestAnchorInPixels /
+                                  kMinimumBoundingBoxSize)) +
+       kResizeThresholdAlignment - 1) /
+      kResizeThresholdAlignment * kResizeThresholdAlignment;
+
+  const auto& images = PreloadImages(dispenser, 20);
+  const auto& settings = NewSettings(1, PerformanceMode::kAccurate106);
+  const auto& new_options = [&](int resize_threshold) {
+    return clova::face::OptionsBuilder()
+        .SetBoundingBoxThreshold(0.7f)
+        .SetInformationToObtain(clova::face::Options::kBoundingBoxes)
+        .SetMinimumBoundingBoxSize(kMinimumBoundingBoxSize)
+        .SetResizeThreshold(resize_threshold)
+        .SetSmoothingContour(false)
+        .SetSmoothingRect(false)
+        .Build();
+  };
+
+  std::vector<std::vector<clova::Rect>> expected_boxes;
+  {
+    clova::ClovaSee clova_see(settings);
+    const auto& options = new_options(kReferenceResizeThreshold);
+    for (const auto& image : images) {
+      const auto& frame = image.frame();
+      const float minimum_size =
+          std::max(frame.width(), frame.height()) * kMinimumBoundingBoxSize;
+      expected_boxes.emplace_back();
+      for (const auto& face : clova_see.Run(frame, options).faces()) {
+        const auto& box = face.bounding_box();
+        if (std::max(box.width(), box.height()) >= minimum_size)
+          expected_boxes.back().push_back(box);
+      }
+    }
+  }
+
+  for (int resize_threshold = kReferenceResizeThreshold;
+       resize_threshold >= derived_resize_threshold;
+       resize_threshold -= kResizeThresholdAlignment) {
+    clova::ClovaSee clova_see(settings);
+    const auto& options = new_options(resize_threshold);
+    WarmUp(clova_see, dispenser, options);
+
+    float latency_in_milli = 0.0f;
+    size_t expected_count = 0;
+    size_t found_count = 0;
+    for (size_t index = 0; index < images.size(); ++index) {
+      const auto& result = clova_see.Run(images[index].frame(), options);
+      latency_in_milli += 1000.0f / clova_see.GetMeasureResult().total_fps;
+      for (const auto& expected_box : expected_boxes[index]) {
+        ++expected_count;
+        for (const auto& face : result.faces()) {
+          if (GetIntersectionOverUnion(face.bounding_box(), expected_box) >=
+              kMinimumIntersectionOverUnion) {
+            ++found_count;
+            break;
+          }
+        }
+      }
+    }
+
+    fmt::print("Resize Threshold {:>3}: {:>8.2f}ms, recall {:>5.1f}% "
+               "({}/{})\n",
+               resize_threshold,
+               latency_in_milli / std::max<size_t>(images.size(), 1),
+               expected_count > 0 ? 100.0f * found_count / expected_count
+                                  : 100.0f,
+               found_count,
+               expected_count);
+  }
+  std::cout << std::endl;
+}
+
+// Reports how the resident memory grows with the number of ClovaSee
+// instances, i.e. one instance per camera stream. Every instance runs once so
+// that all of its models are loaded before measuring.
+void DoMultiInstanceBenchmark(const BenchmarkImageDispenser& dispenser) {
+  const std::vector<size_t> instance_counts { 1, 2, 4, 8 };
+  const auto& options = NewOptions();
+
+  for (const auto& instance_count : instance_counts) {
+    const size_t baseline_in_bytes = ResetMemoryBaseline();
+    std::vector<std::unique_ptr<clova::ClovaSee>> instances;
+    for (size_t count = 0; count < instance_count; ++count) {
+      instances.push_back(std::make_unique<clova::ClovaSee>(
+          NewSettings(1, PerformanceMode::kAccurate106)));
+      instances.back()->Run(dispenser.RandomNext().frame(), options);
+    }
+    const size_t resident_in_bytes =
+        std::max(GetResidentMemoryInBytes(), baseline_in_bytes)
+        - baseline_in_bytes;
+
+    fmt::print("Instances {:>2}: {:>8.2f}MB resident, {:>8.2f}MB/instance\n",
+               instance_count,
+               ToMegaBytes(resident_in_bytes),
+               ToMegaBytes(resident_in_bytes) / instance_count);
+  }
+  std::cout << std::endl;
+}
+
+// Reports, for growing sets of requested information, how long it takes to
+// construct a ClovaSee and how much slower its first Run is than the steady
+// state. The difference is the cost of loading the models that the newly
+// requested stages need.
+void DoLoadTimeBenchmark(const BenchmarkImageDispenser& dispenser) {
+  using Options = clova::face::Options;
+  const std::vector<std::pair<std::string, uint32_t>> stages {
+    { "D+T", Options::kBoundingBoxes | Options::kTrackingIDs },
+    { "+L", Options::kContours },
+    { "+E", Options::kEulerAngles },
+    { "+MD", Options::kMasks },
+    { "+SD", Options::kSpoofs },
+    { "+R", Options::kFeatures },
+    { "All", Options::kAll },
+  };
+  constexpr size_t kSteadyStateRepeatCount = 10;
+
+  using namespace clova;
+  uint32_t information_to_obtain = 0;
+  for (const auto& stage : stages) {
+    information_to_obtain |= stage.second;
+    const auto& options = clova::face::OptionsBuilder()
+        .SetBoundingBoxThreshold(0.7f)
+        .SetInformationToObtain(information_to_obtain)
+        .SetResizeThreshold(320)
+        .Build();
+    const size_t baseline_in_bytes = ResetMemoryBaseline();
+
+    float construction_in_milli = 0.0f;
+    std::unique_ptr<clova::ClovaSee> clova_see;
+    measure_in_milli(construction_in_milli) {
+      clova_see = std::make_unique<clova::ClovaSee>(
+          NewSettings(1, PerformanceMode::kAccurate106));
+    }
+
+    float first_run_in_milli = 0.0f;
+    measure_in_milli(first_run_in_milli) {
+      clova_see->Run(dispenser.RandomNext().frame(), options);
+    }
+
+    float steady_state_in_milli = 0.0f;
+    for (size_t count = 0; count < kSteadyStateRepeatCount; ++count) {
+      clova_see->Run(dispenser.RandomNext().frame(), options);
+      steady_state_in_milli +=
+          1000.0f / clova_see->GetMeasureResult().total_fps;
+    }
+    steady_state_in_milli /= kSteadyStateRepeatCount;
+
+    const size_t peak_in_bytes =
+        std::max(GetPeakResidentMemoryInBytes(), baseline_in_bytes)
+        - baseline_in_bytes;
+    fmt::print("{:>4}: construct {:>8.2f}ms, first run {:>8.2f}ms, "
+               "load {:>8.2f}ms, peak {:>8.2f}MB\n",
+               stage.first,
+               construction_in_milli,
+               first_run_in_milli,
+               std::max(first_run_in_milli - steady_state_in_milli, 0.0f),
+               ToMegaBytes(peak_in_bytes));
+  }
+  std::cout << std::endl;
+}
+
+// Reports, per performance mode, the peak resident memory a ClovaSee takes
+// from its construction through its steady state, and the heap allocations
+// of a steady-state Run. Only the allocations through operator new count,
+// not those made with malloc directly.
+void DoMemoryBenchmark(const BenchmarkImageDispenser& dispenser) {
+  constexpr size_t kWarmUpCount = 5;
+  constexpr size_t kSteadyStateRepeatCount = 20;
+  const auto& images = PreloadImages(dispenser, 10);
+  const auto& options = NewOptions();
+
+  for (const auto& performance_mode : { PerformanceMode::kAccurate106,
+                                        PerformanceMode::kAccurate98,
+                                        PerformanceMode::kFast }) {
+    const size_t baseline_in_bytes = ResetMemoryBaseline();
+    auto clova_see = std::make_unique<clova::ClovaSee>(
+        NewSettings(1, performance_mode));
+    for (size_t count = 0; count < kWarmUpCount; ++count)
+      clova_see->Run(images[count % images.size()].frame(), options);
+
+    const size_t baseline_allocation_count = allocation_count;
+    const size_t baseline_allocated_bytes = allocated_bytes;
+    is_counting_allocations.store(true, std::memory_order_relaxed);
+    for (size_t count = 0; count < kSteadyStateRepeatCount; ++count)
+      clova_see->Run(images[count % images.size()].frame(), options);
+    is_counting_allocations.store(false, std::memory_order_relaxed);
+    const float allocations_per_run =
+        static_cast<float>(allocation_count - baseline_allocation_count)
+        / kSteadyStateRepeatCount;
+    const float allocated_kilo_bytes_per_run =
+        (allocated_bytes - baseline_allocated_bytes) / 1024.0f
+        / kSteadyStateRepeatCount;
+
+    const size_t peak_in_bytes =
+        std::max(GetPeakResidentMemoryInBytes(), baseline_in_bytes)
+        - baseline_in_bytes;
+    fmt::print("{:>12}: peak {:>8.2f}MB, {:>8.1f} allocations/run, "
+               "{:>8.2f}KB/run\n",
+               ToString(performance_mode),
+               ToMegaBytes(peak_in_bytes),
+               allocations_per_run,
+               allocated_kilo_bytes_per_run);
+  }
+  std::cout << std::endl;
+}
+
+// Returns the index of the feature in |gallery| most similar to |query|. All
+// features are L2-normalized, so the dot product is the cosine similarity.
+size_t FindMostSimilar(const std::vector<clova::Feature>& gallery,
+                       const clova::Feature& query) {
+  size_t best_index = 0;
+  float best_similarity = std::numeric_limits<float>::lowest();
+  for (size_t index = 0; index < gallery.size(); ++index) {
+    const float similarity = std::inner_product(
+        query.cbegin(), query.cend(), gallery[index].cbegin(), 0.0f);
+    if (similarity > best_similarity) {
+      best_similarity = similarity;
+      best_index = index;
+    }
+  }
+  return best_index;
+}
+
+clova::Feature Normalize(clova::Feature feature) {
+  const float norm = std::sqrt(std::inner_product(
+      feature.cbegin(), feature.cend(), feature.cbegin(), 0.0f));
+  if (norm > 0.0f) {
+    for (auto& element : feature)
+      element /= norm;
+  }
+  return feature;
+}
+
+clova::Feature NewRandomFeature(std::mt19937& randomizer, size_t dimension) {
+  std::normal_distribution<float> distributor;
+  clova::Feature feature(dimension);
+  for (auto& element : feature)
+    element = distributor(randomizer);
+  return Normalize(std::move(feature));
+}
+
+// Compares 1:N matching on full 512-d features against their 128-d
+// projections.
+//
+// Whether the projection keeps the ranking is measured on the features of the
+// benchmark images, every image once: the gallery holds the largest face of
+// each image from kAccurate106, and the queries are the same faces from
+// kFast. Reported are how often the compact gallery returns the entry of the
+// full one, and how often each returns the image of the query.
+//
+// The full features are matched by test::PeopleSearch. It takes 512-d
+// features only, so the compact gallery of the same population is searched
+// by brute force.
+void DoCompactFeatureBenchmark(const BenchmarkImageDispenser& dispenser,
+                               const clova::Paths& paths) {
+  constexpr size_t kFullDimension = 512;
+  constexpr size_t kCompactDimension = 128;
+  constexpr size_t kQueryCount = 100;
+  const FeatureProjector projector(kFullDimension, kCompactDimension);
+
+  std::vector<clova::test::Image> images;
+  for (const auto& path : paths)
+    images.push_back(clova::test::Image::New(path));
+  float latency_in_milli = 0.0f;
+  const auto& gallery_faces = GetLargestFaces(
+      dispenser, images, NewSettings(1, PerformanceMode::kAccurate106),
+      latency_in_milli);
+  const auto& query_faces = GetLargestFaces(
+      dispenser, images, NewSettings(1, PerformanceMode::kFast),
+      latency_in_milli);
+
+  std::vector<clova::Feature> gallery;
+  std::vector<clova::Feature> compact_gallery;
+  std::vector<size_t> gallery_indices(images.size(), images.size());
+  for (size_t index = 0; index < images.size(); ++index) {
+    if (gallery_faces[index].empty() ||
+        gallery_faces[index].front().feature().size() != kFullDimension)
+      continue;
+    gallery_indices[index] = gallery.size();
+    gallery.push_back(Normalize(gallery_faces[index].front().feature()));
+    compact_gallery.push_back(projector.Project(gallery.back()));
+  }
+
+  size_t query_count = 0;
+  size_t agreement_count = 0;
+  size_t full_hit_count = 0;
+  size_t compact_hit_count = 0;
+  for (size_t index = 0; index < images.size(); ++index) {
+    if (gallery_indices[index] == images.size() ||
+        query_faces[index].empty() ||
+        query_faces[index].front().feature().size() != kFullDimension)
+      continue;
+    const auto& query = Normalize(query_faces[index].front().feature());
+    const size_t full_index = FindMostSimilar(gallery, query);
+    const size_t compact_index =
+        FindMostSimilar(compact_gallery, projector.Project(query));
+    ++query_count;
+    agreement_count += full_index == compact_index;
+    full_hit_count += full_index == gallery_indices[index];
+    compact_hit_count += compact_index == gallery_indices[index];
+  }
+  if (query_count > 0) {
+    fmt::print("Compact Feature 1:{:>6}: agreement {:>5.1f}%, top-1 {:>3}d "
+               "{:>5.1f}%, {:>3}d {:>5.1f}%\n",
+               gallery.size(),
+               100.0f * agreement_count / query_count,
+               kFullDimension,
+               100.0f * full_hit_count / query_count,
+               kCompactDimension,
+               100.0f * compact_hit_count / query_count);
+  }
+
+  std::mt19937 randomizer(0);
+  for (const uint32_t population : { 100000, 10000, 1000 }) {
+    const auto& people_search = clova::test::PeopleSearch::New(population);
+    std::vector<clova::Feature> random_compact_gallery;
+    for (size_t index = 0; index < people_search->people().size(); ++index) {
+      random_compact_gallery.push_back(
+          NewRandomFeature(randomizer, kCompactDimension));
+    }
+
+    float full_in_milli = 0.0f;
+    float compact_in_milli = 0.0f;
+    for (size_t count = 0; count < kQueryCount; ++count) {
+      const auto& query = NewRandomFeature(randomizer, kFullDimension);
+      const auto& compact_query = projector.Project(query);
+
+      float elapsed_in_milli = 0.0f;
+      using namespace clova;
+      measure_in_milli(elapsed_in_milli) {
+        people_search->Find(query);
+      }
+      full_in_milli += elapsed_in_milli;
+      measure_in_milli(elapsed_in_milli) {
+        FindMostSimilar(random_compact_gallery, compact_query);
+      }
+      compact_in_milli += elapsed_in_milli;
+    }
+
+    const size_t size = people_search->people().size();
+    fmt::print("Compact Feature 1:{:>6}: {:>3}d {:>8.2f}MB {:>7.2f}ms, "
+               "{:>3}d {:>8.2f}MB {:>7.2f}ms\n",
+               size,
+               kFullDimension,
+               ToMegaBytes(size * kFullDimension * sizeof(float)),
+               full_in_milli / kQueryCount,
+               kCompactDimension,
+               ToMegaBytes(size * kCompactDimension * sizeof(float)),
+               compact_in_milli / kQueryCount);
+  }
+  std::cout << std::endl;
+}
+
 void DoPeopleSearchBenchmark() {
   const std::vector<uint32_t> populations { 100000, 50000, 10000, 5000, 1000 };
   const auto& maximum_length = std::to_string(
@@ -319,6 +1375,25 @@ void DoPeopleSearchBenchmark() {
 
 }  // namespace
 
+////////////////////////////////////////////////////////////////////////////////
+// Allocation Counting
+
+// Counts the allocations of the process for DoMemoryBenchmark(). The array
+// and nothrow forms fall back to these by default.
+void* operator new(size_t size) {
+  if (is_counting_allocations.load(std::memory_order_relaxed)) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // main()
 
@@ -331,21 +1406,36 @@ int main(int argc, char* argv[]) {
   }
 
   BenchmarkImageDispenser dispenser(benchmark_image_paths);
-  DoWarmUp(dispenser);
+  DoLoadTimeBenchmark(dispenser);
 
+  std::map<PerformanceMode, ThreadScaling> thread_scalings;
   for (const auto& number_of_threads: { 1, 2, 4 }) {
     for (const auto& performance_mode : { PerformanceMode::kAccurate106,
                                           PerformanceMode::kAccurate98,
                                           PerformanceMode::kFast }) {
-      DoBenchmark(dispenser,
-                  100,  // repeat_count
-                  10,   // logging_step
-                  NewSettings(number_of_threads, performance_mode));
+      thread_scalings[performance_mode][number_of_threads] =
+          DoBenchmark(dispenser,
+                      100,  // repeat_count
+                      10,   // logging_step
+                      NewSettings(number_of_threads, performance_mode));
       DoCoolDown();
     }
   }
 
+  for (const auto& pair : thread_scalings)
+    PrintThreadScaling(pair.first, pair.second);
+
+  DoCpuAffinityBenchmark(dispenser);
+
+  DoMultiStreamBenchmark(dispenser, 4);
+  DoSessionBenchmark(dispenser);
+  DoConcurrentRunBenchmark(dispenser);
+  DoEmbeddingDriftBenchmark(dispenser);
+  DoResizeThresholdBenchmark(dispenser);
+  DoMultiInstanceBenchmark(dispenser);
+  DoMemoryBenchmark(dispenser);
   DoPeopleSearchBenchmark();
+  DoCompactFeatureBenchmark(dispenser, benchmark_image_paths);
 
   return EXIT_SUCCESS;
 }
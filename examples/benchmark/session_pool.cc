@@ -0,0 +1,100 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "session_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace benchmark {
+
+////////////////////////////////////////////////////////////////////////////////
+// class SessionPool::Session
+
+SessionPool::Session::Session(SessionPool& pool,
+                              size_t id,
+                              std::unique_ptr<clova::ClovaSee> instance)
+    : pool_(pool),
+      id_(id),
+      instance_(std::move(instance)) {
+}
+
+SessionPool::Session::~Session() {
+  if (is_stateful())
+    --pool_.number_of_stateful_sessions_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class SessionPool
+
+SessionPool::SessionPool(const clova::Settings& settings,
+                         size_t number_of_shared_instances)
+    : settings_(settings),
+      next_session_id_(0),
+      number_of_stateful_sessions_(0) {
+  number_of_shared_instances = std::max<size_t>(number_of_shared_instances, 1);
+  for (size_t index = 0; index < number_of_shared_instances; ++index) {
+    shared_instances_.push_back(std::make_unique<clova::ClovaSee>(settings_));
+    idle_instances_.push_back(shared_instances_.back().get());
+  }
+}
+
+SessionPool::~SessionPool() {
+}
+
+std::unique_ptr<SessionPool::Session> SessionPool::CreateSession(
+    bool is_stateful) {
+  std::unique_ptr<clova::ClovaSee> instance;
+  if (is_stateful) {
+    instance = std::make_unique<clova::ClovaSee>(settings_);
+    ++number_of_stateful_sessions_;
+  }
+  return std::unique_ptr<Session>(
+      new Session(*this, next_session_id_++, std::move(instance)));
+}
+
+clova::face::Result SessionPool::Run(Session& session,
+                                     const clova::Frame& frame,
+                                     const clova::face::Options& options) {
+  if (session.is_stateful())
+    return session.instance_->Run(frame, options);
+
+  auto* instance = AcquireSharedInstance();
+  auto result = instance->Run(frame, options);
+  ReleaseSharedInstance(instance);
+  return result;
+}
+
+size_t SessionPool::number_of_instances() const {
+  return shared_instances_.size() + number_of_stateful_sessions_;
+}
+
+clova::ClovaSee* SessionPool::AcquireSharedInstance() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this]() { return !idle_instances_.empty(); });
+  auto* instance = idle_instances_.back();
+  idle_instances_.pop_back();
+  return instance;
+}
+
+void SessionPool::ReleaseSharedInstance(clova::ClovaSee* instance) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_instances_.push_back(instance);
+  }
+  condition_.notify_one();
+}
+
+}  // namespace benchmark
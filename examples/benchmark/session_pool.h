@@ -0,0 +1,91 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_BENCHMARK_SESSION_POOL_H_
+#define EXAMPLES_BENCHMARK_SESSION_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "base/frame.h"
+#include "base/settings.h"
+#include "face/options.h"
+#include "sdk/clova_see.h"
+
+namespace benchmark {
+
+// Serves many streams from as few ClovaSee instances as possible.
+//
+// A stateful session, i.e. one that wants tracking IDs or smoothing, keeps an
+// instance of its own because that state lives in the instance. A stateless
+// session borrows whichever shared instance is idle for the duration of a
+// single Run, so any number of stateless sessions costs only the shared
+// instances.
+//
+// Run may be called concurrently for different sessions. Calls for the same
+// stateful session must be serialized by the caller. Sessions must be
+// destroyed before the pool that created them.
+class SessionPool {
+ public:
+  class Session {
+   public:
+    virtual ~Session();
+
+    size_t id() const { return id_; }
+    bool is_stateful() const { return instance_ != nullptr; }
+
+   private:
+    friend class SessionPool;
+
+    Session(SessionPool& pool,
+            size_t id,
+            std::unique_ptr<clova::ClovaSee> instance);
+
+    SessionPool& pool_;
+    const size_t id_;
+    const std::unique_ptr<clova::ClovaSee> instance_;
+  };
+
+  SessionPool(const clova::Settings& settings,
+              size_t number_of_shared_instances);
+  virtual ~SessionPool();
+
+  std::unique_ptr<Session> CreateSession(bool is_stateful);
+
+  clova::face::Result Run(Session& session,
+                          const clova::Frame& frame,
+                          const clova::face::Options& options);
+
+  size_t number_of_instances() const;
+
+ private:
+  clova::ClovaSee* AcquireSharedInstance();
+  void ReleaseSharedInstance(clova::ClovaSee* instance);
+
+  const clova::Settings settings_;
+  std::vector<std::unique_ptr<clova::ClovaSee>> shared_instances_;
+  std::vector<clova::ClovaSee*> idle_instances_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::atomic<size_t> next_session_id_;
+  std::atomic<size_t> number_of_stateful_sessions_;
+};
+
+}  // namespace benchmark
+
+#endif  // EXAMPLES_BENCHMARK_SESSION_POOL_H_
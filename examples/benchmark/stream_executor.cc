@@ -0,0 +1,109 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stream_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace benchmark {
+
+StreamExecutor::StreamExecutor(size_t number_of_workers)
+    : queued_count_(0),
+      unfinished_count_(0),
+      quit_requested_(false) {
+  number_of_workers = std::max<size_t>(number_of_workers, 1);
+  for (size_t index = 0; index < number_of_workers; ++index)
+    queues_.push_back(std::make_unique<Queue>());
+  for (size_t index = 0; index < number_of_workers; ++index)
+    workers_.emplace_back(&StreamExecutor::Work, this, index);
+}
+
+StreamExecutor::~StreamExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_requested_ = true;
+  }
+  task_condition_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+void StreamExecutor::Submit(size_t stream_id, Task task) {
+  // The counters go up before the task is queued, so a worker may find them
+  // ahead of the queues for a moment but never behind.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++unfinished_count_;
+    ++queued_count_;
+  }
+  auto& queue = *queues_[stream_id % queues_.size()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  task_condition_.notify_all();
+}
+
+void StreamExecutor::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_condition_.wait(lock, [this]() { return unfinished_count_ == 0; });
+}
+
+void StreamExecutor::Work(size_t worker_index) {
+  while (true) {
+    Task task;
+    if (Pop(worker_index, task) || Steal(worker_index, task)) {
+      --queued_count_;
+      task();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--unfinished_count_ == 0)
+        idle_condition_.notify_all();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_condition_.wait(lock, [this]() {
+      return quit_requested_ || queued_count_ > 0;
+    });
+    if (quit_requested_ && queued_count_ == 0)
+      return;
+  }
+}
+
+bool StreamExecutor::Pop(size_t worker_index, Task& task) {
+  auto& queue = *queues_[worker_index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty())
+    return false;
+  task = std::move(queue.tasks.front());
+  queue.tasks.pop_front();
+  return true;
+}
+
+bool StreamExecutor::Steal(size_t worker_index, Task& task) {
+  for (size_t offset = 1; offset < queues_.size(); ++offset) {
+    auto& queue = *queues_[(worker_index + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+      continue;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace benchmark
@@ -0,0 +1,79 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_BENCHMARK_STREAM_EXECUTOR_H_
+#define EXAMPLES_BENCHMARK_STREAM_EXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace benchmark {
+
+// A process-wide pool of workers shared by many streams, i.e. one ClovaSee
+// per camera, so that the total number of threads stays at the number of
+// cores however many streams there are.
+//
+// Each worker owns a queue. A task is queued on the worker its stream maps
+// to, which keeps a stream on the same core while the load is even, and an
+// idle worker steals from the back of the other queues otherwise.
+//
+// The executor does not serialize the tasks of a stream. A stream that is not
+// reentrant, such as a ClovaSee, should submit its next task from the end of
+// the current one.
+class StreamExecutor {
+ public:
+  using Task = std::function<void()>;
+
+  explicit StreamExecutor(size_t number_of_workers);
+  virtual ~StreamExecutor();
+
+  void Submit(size_t stream_id, Task task);
+
+  // Blocks until every submitted task, including the ones submitted by tasks,
+  // has finished.
+  void Wait();
+
+  size_t number_of_workers() const { return queues_.size(); }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Work(size_t worker_index);
+  bool Pop(size_t worker_index, Task& task);
+  bool Steal(size_t worker_index, Task& task);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable task_condition_;
+  std::condition_variable idle_condition_;
+  std::atomic<size_t> queued_count_;
+  size_t unfinished_count_;
+  bool quit_requested_;
+};
+
+}  // namespace benchmark
+
+#endif  // EXAMPLES_BENCHMARK_STREAM_EXECUTOR_H_
@@ -0,0 +1,94 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "combined_runner.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/settings.h"
+
+namespace example {
+
+namespace {
+
+clova::Settings NewSettings(int number_of_threads) {
+  return clova::SettingsBuilder()
+      .SetIntermittentInformationRatio(1)
+      .SetNumberOfThreads(number_of_threads)
+      .Build();
+}
+
+// The face, body and OCR pipelines run at once, and a body stage takes the
+// worker of the body pipeline after it.
+constexpr size_t kNumberOfStageWorkers = 3;
+
+}  // namespace
+
+CombinedRunner::CombinedRunner(int number_of_threads_per_instance)
+    : face_instance_(NewSettings(number_of_threads_per_instance)),
+      body_instance_(NewSettings(number_of_threads_per_instance)),
+      number_of_threads_per_instance_(number_of_threads_per_instance),
+      stage_graph_(kNumberOfStageWorkers),
+      frame_(nullptr),
+      face_options_(nullptr),
+      body_options_(nullptr),
+      ocr_options_(nullptr),
+      body_stage_(nullptr) {
+  stage_graph_.Add("face", {}, [this] {
+    result_.face = face_instance_.Run(*frame_, *face_options_);
+  });
+  stage_graph_.Add("body", {}, [this] {
+    result_.body = body_instance_.Run(*frame_, *body_options_);
+  });
+  stage_graph_.Add("body_stage", {"body"}, [this] {
+    (*body_stage_)(result_.body);
+  });
+  stage_graph_.Add("ocr", {}, [this] {
+    if (!ocr_instance_) {
+      ocr_instance_ = std::make_unique<clova::ClovaSee>(
+          NewSettings(number_of_threads_per_instance_));
+    }
+    result_.ocr = ocr_instance_->Run(*frame_, *ocr_options_);
+  });
+}
+
+CombinedRunner::~CombinedRunner() {
+}
+
+CombinedRunner::Result CombinedRunner::Run(
+    const clova::Frame& frame,
+    const clova::face::Options& face_options,
+    const clova::body::Options& body_options,
+    const clova::ocr::Options* ocr_options,
+    const BodyStage& body_stage) {
+  frame_ = &frame;
+  face_options_ = &face_options;
+  body_options_ = &body_options;
+  ocr_options_ = ocr_options;
+  body_stage_ = &body_stage;
+  result_ = Result();
+
+  std::vector<std::string> targets {"face", "body"};
+  if (ocr_options)
+    targets.push_back("ocr");
+  if (body_stage)
+    targets.push_back("body_stage");
+  stage_graph_.Run(targets);
+  return std::move(result_);
+}
+
+}  // namespace example
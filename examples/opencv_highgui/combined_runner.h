@@ -0,0 +1,77 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_COMBINED_RUNNER_H_
+#define EXAMPLES_OPENCV_HIGHGUI_COMBINED_RUNNER_H_
+
+#include <functional>
+#include <memory>
+
+#include "base/frame.h"
+#include "body/options.h"
+#include "face/options.h"
+#include "ocr/options.h"
+#include "sdk/clova_see.h"
+#include "stage_graph.h"
+
+namespace example {
+
+// Runs the face, body and OCR pipelines on the same frame at once, each on a
+// ClovaSee instance of its own, and gathers their results. The frame is
+// wrapped once and read by all of them. The pipelines are stages of a graph,
+// so that only the requested ones are scheduled. The OCR instance is created
+// by the first Run that asks for OCR.
+//
+// A body stage, such as compositing with the mask, runs on the body result as
+// soon as it is ready, while the face and OCR pipelines may still be running.
+class CombinedRunner {
+ public:
+  struct Result {
+    clova::face::Result face;
+    clova::body::Result body;
+    clova::ocr::Result ocr;
+  };
+
+  using BodyStage = std::function<void(const clova::body::Result&)>;
+
+  explicit CombinedRunner(int number_of_threads_per_instance);
+  virtual ~CombinedRunner();
+
+  // OCR is left out, and |ocr| of the result empty, without |ocr_options|.
+  Result Run(const clova::Frame& frame,
+             const clova::face::Options& face_options,
+             const clova::body::Options& body_options,
+             const clova::ocr::Options* ocr_options = nullptr,
+             const BodyStage& body_stage = nullptr);
+
+ private:
+  clova::ClovaSee face_instance_;
+  clova::ClovaSee body_instance_;
+  std::unique_ptr<clova::ClovaSee> ocr_instance_;
+  const int number_of_threads_per_instance_;
+
+  StageGraph stage_graph_;
+  // The arguments and the result of the Run in progress, for the stages.
+  const clova::Frame* frame_;
+  const clova::face::Options* face_options_;
+  const clova::body::Options* body_options_;
+  const clova::ocr::Options* ocr_options_;
+  const BodyStage* body_stage_;
+  Result result_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_COMBINED_RUNNER_H_
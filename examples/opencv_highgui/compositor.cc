@@ -0,0 +1,317 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compositor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace example {
+
+namespace {
+
+// Divides a blended value of at most 255 * 255 by 255, with rounding. The
+// same approximation is what vraddhn_u16 computes on NEON.
+inline uint8_t DivideBy255(uint32_t value) {
+  return static_cast<uint8_t>((value + (value >> 8) + 128) >> 8);
+}
+
+inline uint8_t Blend(uint8_t foreground, uint8_t background, uint8_t alpha) {
+  return DivideBy255(foreground * alpha + background * (255 - alpha));
+}
+
+#if defined(__SSE2__)
+// Blends 8 bytes widened to 16 bits, each with its own alpha.
+inline __m128i Blend(__m128i foreground, __m128i background, __m128i alpha) {
+  const __m128i inverse_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  __m128i value = _mm_add_epi16(_mm_mullo_epi16(foreground, alpha),
+                                _mm_mullo_epi16(background, inverse_alpha));
+  value = _mm_add_epi16(value, _mm_srli_epi16(value, 8));
+  value = _mm_add_epi16(value, _mm_set1_epi16(128));
+  return _mm_srli_epi16(value, 8);
+}
+
+// Blends the 16 bytes at |index| with |low| and |high|, the alphas of their
+// first and last 8 bytes widened to 16 bits.
+inline void Blend16(const uint8_t* foreground,
+                    const uint8_t* background,
+                    __m128i low,
+                    __m128i high,
+                    uint8_t* output) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i f =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(foreground));
+  const __m128i b =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(background));
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i*>(output),
+      _mm_packus_epi16(Blend(_mm_unpacklo_epi8(f, zero),
+                             _mm_unpacklo_epi8(b, zero), low),
+                       Blend(_mm_unpackhi_epi8(f, zero),
+                             _mm_unpackhi_epi8(b, zero), high)));
+}
+
+// Repeats each of the 8 alphas of |alpha|, widened to 16 bits, three times,
+// which gives the alphas of the 24 bytes of 8 BGR pixels in three registers.
+inline void BroadcastToBgr(__m128i alpha, __m128i broadcast[3]) {
+  const __m128i lower = _mm_unpacklo_epi64(alpha, alpha);
+  const __m128i upper = _mm_unpackhi_epi64(alpha, alpha);
+  broadcast[0] = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(lower, _MM_SHUFFLE(1, 0, 0, 0)),
+      _MM_SHUFFLE(2, 2, 1, 1));
+  broadcast[1] = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 2)),
+      _MM_SHUFFLE(1, 0, 0, 0));
+  broadcast[2] = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(upper, _MM_SHUFFLE(2, 2, 1, 1)),
+      _MM_SHUFFLE(3, 3, 3, 2));
+}
+#elif defined(__ARM_NEON)
+inline uint8x16_t Blend(uint8x16_t foreground,
+                        uint8x16_t background,
+                        uint8x16_t alpha) {
+  const uint8x16_t inverse_alpha = vmvnq_u8(alpha);
+  uint16x8_t low = vmull_u8(vget_low_u8(foreground), vget_low_u8(alpha));
+  low = vmlal_u8(low, vget_low_u8(background), vget_low_u8(inverse_alpha));
+  uint16x8_t high = vmull_u8(vget_high_u8(foreground), vget_high_u8(alpha));
+  high = vmlal_u8(high, vget_high_u8(background),
+                  vget_high_u8(inverse_alpha));
+  return vcombine_u8(vraddhn_u16(low, vshrq_n_u16(low, 8)),
+                     vraddhn_u16(high, vshrq_n_u16(high, 8)));
+}
+#endif
+
+// Blends |width| pixels of |channel_count| interleaved bytes, every byte of a
+// pixel with the alpha of the pixel. The SIMD paths repeat the alphas in
+// registers, so no expanded alpha row is ever written.
+void BlendPixels(const uint8_t* foreground,
+                 const uint8_t* background,
+                 const uint8_t* alpha,
+                 uint8_t* output,
+                 int width,
+                 int channel_count) {
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 16 <= width; x += 16) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + x));
+    const __m128i a_low = _mm_unpacklo_epi8(a, zero);
+    const __m128i a_high = _mm_unpackhi_epi8(a, zero);
+    const int offset = x * channel_count;
+    if (channel_count == 1) {
+      Blend16(foreground + offset, background + offset, a_low, a_high,
+              output + offset);
+    } else if (channel_count == 3) {
+      __m128i broadcast[6];
+      BroadcastToBgr(a_low, broadcast);
+      BroadcastToBgr(a_high, broadcast + 3);
+      for (int part = 0; part < 3; ++part) {
+        Blend16(foreground + offset + part * 16,
+                background + offset + part * 16,
+                broadcast[part * 2], broadcast[part * 2 + 1],
+                output + offset + part * 16);
+      }
+    } else {
+      const __m128i pairs[4] = {
+        _mm_unpacklo_epi16(a_low, a_low),
+        _mm_unpackhi_epi16(a_low, a_low),
+        _mm_unpacklo_epi16(a_high, a_high),
+        _mm_unpackhi_epi16(a_high, a_high),
+      };
+      for (int part = 0; part < 4; ++part) {
+        Blend16(foreground + offset + part * 16,
+                background + offset + part * 16,
+                _mm_unpacklo_epi32(pairs[part], pairs[part]),
+                _mm_unpackhi_epi32(pairs[part], pairs[part]),
+                output + offset + part * 16);
+      }
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16_t a = vld1q_u8(alpha + x);
+    const int offset = x * channel_count;
+    if (channel_count == 1) {
+      vst1q_u8(output + offset, Blend(vld1q_u8(foreground + offset),
+                                      vld1q_u8(background + offset), a));
+    } else if (channel_count == 3) {
+      const uint8x16x3_t f = vld3q_u8(foreground + offset);
+      const uint8x16x3_t b = vld3q_u8(background + offset);
+      uint8x16x3_t blended;
+      for (int channel = 0; channel < 3; ++channel)
+        blended.val[channel] = Blend(f.val[channel], b.val[channel], a);
+      vst3q_u8(output + offset, blended);
+    } else {
+      const uint8x16x4_t f = vld4q_u8(foreground + offset);
+      const uint8x16x4_t b = vld4q_u8(background + offset);
+      uint8x16x4_t blended;
+      for (int channel = 0; channel < 4; ++channel)
+        blended.val[channel] = Blend(f.val[channel], b.val[channel], a);
+      vst4q_u8(output + offset, blended);
+    }
+  }
+#endif
+  for (; x < width; ++x) {
+    for (int channel = 0; channel < channel_count; ++channel) {
+      const int index = x * channel_count + channel;
+      output[index] = Blend(foreground[index], background[index], alpha[x]);
+    }
+  }
+}
+
+// Blends a VU row of NV21 of |width| bytes, every VU pair with the average
+// alpha of its 2x2 pixels in |upper_alpha| and |lower_alpha|.
+void BlendChroma(const uint8_t* foreground,
+                 const uint8_t* background,
+                 const uint8_t* upper_alpha,
+                 const uint8_t* lower_alpha,
+                 uint8_t* output,
+                 int width) {
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i even_mask = _mm_set1_epi16(0x00ff);
+  for (; x + 16 <= width; x += 16) {
+    const __m128i upper =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper_alpha + x));
+    const __m128i lower =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower_alpha + x));
+    __m128i sum = _mm_add_epi16(_mm_and_si128(upper, even_mask),
+                                _mm_srli_epi16(upper, 8));
+    sum = _mm_add_epi16(sum, _mm_and_si128(lower, even_mask));
+    sum = _mm_add_epi16(sum, _mm_srli_epi16(lower, 8));
+    const __m128i average =
+        _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    Blend16(foreground + x, background + x,
+            _mm_unpacklo_epi16(average, average),
+            _mm_unpackhi_epi16(average, average), output + x);
+  }
+#endif
+  for (; x + 1 < width; x += 2) {
+    const auto average = static_cast<uint8_t>(
+        (upper_alpha[x] + upper_alpha[x + 1] +
+         lower_alpha[x] + lower_alpha[x + 1] + 2) >> 2);
+    output[x] = Blend(foreground[x], background[x], average);
+    output[x + 1] = Blend(foreground[x + 1], background[x + 1], average);
+  }
+}
+
+int GetChannelCount(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kBGR_888:
+      return 3;
+    case PixelFormat::kRGBA_8888:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+void CheckLayout(const cv::Mat& foreground,
+                 const cv::Mat& alpha,
+                 const cv::Mat& background,
+                 PixelFormat format) {
+  assert(alpha.type() == CV_8UC1);
+  assert(foreground.size() == background.size());
+  assert(foreground.type() == background.type());
+  if (format == PixelFormat::kNV21) {
+    assert(foreground.type() == CV_8UC1 && alpha.cols % 2 == 0 &&
+           foreground.size() == cv::Size(alpha.cols, alpha.rows * 3 / 2));
+  } else {
+    assert(foreground.type() == CV_8UC(GetChannelCount(format)) &&
+           foreground.size() == alpha.size());
+  }
+}
+
+}  // namespace
+
+void Composite(const cv::Mat& foreground,
+               const cv::Mat& alpha,
+               const cv::Mat& background,
+               PixelFormat format,
+               cv::Mat& output,
+               bool is_parallel) {
+  CheckLayout(foreground, alpha, background, format);
+  const int width = alpha.cols;
+  const int height = alpha.rows;
+  const int channel_count = GetChannelCount(format);
+  output.create(foreground.size(), foreground.type());
+
+  const auto composite_rows = [&](const cv::Range& range) {
+    for (int y = range.start; y < range.end; ++y) {
+      if (y >= height) {
+        const int upper = (y - height) * 2;
+        BlendChroma(foreground.ptr<uint8_t>(y), background.ptr<uint8_t>(y),
+                    alpha.ptr<uint8_t>(upper),
+                    alpha.ptr<uint8_t>(std::min(upper + 1, height - 1)),
+                    output.ptr<uint8_t>(y), width);
+      } else {
+        BlendPixels(foreground.ptr<uint8_t>(y), background.ptr<uint8_t>(y),
+                    alpha.ptr<uint8_t>(y), output.ptr<uint8_t>(y), width,
+                    channel_count);
+      }
+    }
+  };
+
+  const cv::Range rows(0, foreground.rows);
+  if (is_parallel)
+    cv::parallel_for_(rows, composite_rows);
+  else
+    composite_rows(rows);
+}
+
+void CompositeScalar(const cv::Mat& foreground,
+                     const cv::Mat& alpha,
+                     const cv::Mat& background,
+                     PixelFormat format,
+                     cv::Mat& output) {
+  CheckLayout(foreground, alpha, background, format);
+  const int width = alpha.cols;
+  const int height = alpha.rows;
+  const int channel_count = GetChannelCount(format);
+  output.create(foreground.size(), foreground.type());
+
+  for (int y = 0; y < foreground.rows; ++y) {
+    const auto* f = foreground.ptr<uint8_t>(y);
+    const auto* b = background.ptr<uint8_t>(y);
+    auto* o = output.ptr<uint8_t>(y);
+    if (y < height) {
+      const auto* a = alpha.ptr<uint8_t>(y);
+      for (int index = 0; index < width * channel_count; ++index)
+        o[index] = Blend(f[index], b[index], a[index / channel_count]);
+      continue;
+    }
+
+    const int upper = (y - height) * 2;
+    const auto* upper_alpha = alpha.ptr<uint8_t>(upper);
+    const auto* lower_alpha =
+        alpha.ptr<uint8_t>(std::min(upper + 1, height - 1));
+    for (int index = 0; index < width; ++index) {
+      const int x = index & ~1;
+      const int average = (upper_alpha[x] + upper_alpha[x + 1] +
+                           lower_alpha[x] + lower_alpha[x + 1] + 2) >> 2;
+      o[index] = Blend(f[index], b[index], static_cast<uint8_t>(average));
+    }
+  }
+}
+
+}  // namespace example
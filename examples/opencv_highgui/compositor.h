@@ -0,0 +1,46 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_COMPOSITOR_H_
+#define EXAMPLES_OPENCV_HIGHGUI_COMPOSITOR_H_
+
+#include <opencv2/core.hpp>
+
+#include "pixel_format.h"
+
+namespace example {
+
+// Replaces the background of |foreground| by |background| along |alpha|, the
+// CV_8UC1 segment of the frame size, and writes the result into |output|.
+// The blending runs in 16-bit fixed point with SSE2 or NEON where available,
+// the alpha of a pixel being repeated for its channels in registers, and over
+// the rows in parallel if |is_parallel|. |output| may be |foreground| itself.
+void Composite(const cv::Mat& foreground,
+               const cv::Mat& alpha,
+               const cv::Mat& background,
+               PixelFormat format,
+               cv::Mat& output,
+               bool is_parallel = true);
+
+// The plain per-byte loop Composite() has to match exactly, for checking it.
+void CompositeScalar(const cv::Mat& foreground,
+                     const cv::Mat& alpha,
+                     const cv::Mat& background,
+                     PixelFormat format,
+                     cv::Mat& output);
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_COMPOSITOR_H_
@@ -0,0 +1,162 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document_rectifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include <opencv2/imgproc.hpp>
+
+namespace example {
+
+namespace {
+
+constexpr int kFractionBits = 8;
+constexpr int kFractionOne = 1 << kFractionBits;
+
+// BT.601 of the limited range in 20-bit fixed point, as OpenCV converts NV21.
+constexpr int kYuvShift = 20;
+constexpr int kCoefficientY = 1220542;
+constexpr int kCoefficientRV = 1673527;
+constexpr int kCoefficientGV = -852492;
+constexpr int kCoefficientGU = -409993;
+constexpr int kCoefficientBU = 2116026;
+
+inline int Interpolate(int top_left,
+                       int top_right,
+                       int bottom_left,
+                       int bottom_right,
+                       int fraction_x,
+                       int fraction_y) {
+  const int top =
+      top_left * (kFractionOne - fraction_x) + top_right * fraction_x;
+  const int bottom =
+      bottom_left * (kFractionOne - fraction_x) + bottom_right * fraction_x;
+  return (top * (kFractionOne - fraction_y) + bottom * fraction_y +
+          (1 << (kFractionBits * 2 - 1))) >> (kFractionBits * 2);
+}
+
+// Takes the luma bilinearly and the chroma of the nearest 2x2 block.
+void SampleNv21(const cv::Mat& frame,
+                int height,
+                int x,
+                int y,
+                int fraction_x,
+                int fraction_y,
+                uint8_t* pixel) {
+  const auto* top = frame.ptr<uint8_t>(y) + x;
+  const auto* bottom = frame.ptr<uint8_t>(y + 1) + x;
+  const int luma =
+      Interpolate(top[0], top[1], bottom[0], bottom[1], fraction_x,
+                  fraction_y);
+  const auto* vu = frame.ptr<uint8_t>(height + y / 2) + x / 2 * 2;
+  const int v = vu[0] - 128;
+  const int u = vu[1] - 128;
+
+  constexpr int kRounding = 1 << (kYuvShift - 1);
+  const int scaled_luma = std::max(luma - 16, 0) * kCoefficientY + kRounding;
+  pixel[0] = cv::saturate_cast<uint8_t>(
+      (scaled_luma + kCoefficientBU * u) >> kYuvShift);
+  pixel[1] = cv::saturate_cast<uint8_t>(
+      (scaled_luma + kCoefficientGV * v + kCoefficientGU * u) >> kYuvShift);
+  pixel[2] = cv::saturate_cast<uint8_t>(
+      (scaled_luma + kCoefficientRV * v) >> kYuvShift);
+}
+
+}  // namespace
+
+void RectifyDocument(const cv::Mat& frame,
+                     PixelFormat format,
+                     const std::vector<cv::Point>& clockwise_points,
+                     const cv::Size& size,
+                     cv::Mat& document) {
+  assert(clockwise_points.size() == 4);
+  const bool is_nv21 = format == PixelFormat::kNV21;
+  const int width = frame.cols;
+  const int height = is_nv21 ? frame.rows * 2 / 3 : frame.rows;
+  const int channel_count = format == PixelFormat::kRGBA_8888 ? 4 : 3;
+  assert(frame.channels() == (is_nv21 ? 1 : channel_count));
+  document.create(size, channel_count == 4 ? CV_8UC4 : CV_8UC3);
+
+  // Maps the output onto the frame, so that every output pixel is sampled
+  // exactly once.
+  std::vector<cv::Point2f> corners;
+  for (const auto& point : clockwise_points)
+    corners.emplace_back(static_cast<float>(point.x),
+                         static_cast<float>(point.y));
+  const std::vector<cv::Point2f> document_corners{
+      cv::Point2f(0.0f, 0.0f),
+      cv::Point2f(size.width - 1.0f, 0.0f),
+      cv::Point2f(size.width - 1.0f, size.height - 1.0f),
+      cv::Point2f(0.0f, size.height - 1.0f)};
+  const cv::Mat transform =
+      cv::getPerspectiveTransform(document_corners, corners);
+  float m[9];
+  for (int index = 0; index < 9; ++index)
+    m[index] = static_cast<float>(transform.ptr<double>()[index]);
+
+  cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& range) {
+    std::vector<float> xs(size.width);
+    std::vector<float> ys(size.width);
+    for (int y = range.start; y < range.end; ++y) {
+      // The projection of a row is kept free of branches so that it is
+      // vectorized, leaving only the gathers to the sampling loop below.
+      const float x0 = m[1] * y + m[2];
+      const float y0 = m[4] * y + m[5];
+      const float w0 = m[7] * y + m[8];
+      for (int x = 0; x < size.width; ++x) {
+        const float inverse_w = 1.0f / (w0 + m[6] * x);
+        xs[x] = (x0 + m[0] * x) * inverse_w;
+        ys[x] = (y0 + m[3] * x) * inverse_w;
+      }
+
+      auto* pixel = document.ptr<uint8_t>(y);
+      for (int x = 0; x < size.width; ++x, pixel += channel_count) {
+        if (!(xs[x] >= 0.0f && ys[x] >= 0.0f &&
+              xs[x] < width - 1 && ys[x] < height - 1)) {
+          std::fill(pixel, pixel + channel_count, 0);
+          continue;
+        }
+
+        const int fixed_x = static_cast<int>(xs[x] * kFractionOne);
+        const int fixed_y = static_cast<int>(ys[x] * kFractionOne);
+        const int source_x = fixed_x >> kFractionBits;
+        const int source_y = fixed_y >> kFractionBits;
+        const int fraction_x = fixed_x & (kFractionOne - 1);
+        const int fraction_y = fixed_y & (kFractionOne - 1);
+        if (is_nv21) {
+          SampleNv21(frame, height, source_x, source_y, fraction_x,
+                     fraction_y, pixel);
+          continue;
+        }
+
+        const auto* top =
+            frame.ptr<uint8_t>(source_y) + source_x * channel_count;
+        const auto* bottom =
+            frame.ptr<uint8_t>(source_y + 1) + source_x * channel_count;
+        for (int channel = 0; channel < channel_count; ++channel) {
+          pixel[channel] = static_cast<uint8_t>(
+              Interpolate(top[channel], top[channel + channel_count],
+                          bottom[channel], bottom[channel + channel_count],
+                          fraction_x, fraction_y));
+        }
+      }
+    }
+  });
+}
+
+}  // namespace example
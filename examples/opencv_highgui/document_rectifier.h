@@ -0,0 +1,39 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_RECTIFIER_H_
+#define EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_RECTIFIER_H_
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "pixel_format.h"
+
+namespace example {
+
+// Warps the document enclosed by |clockwise_points|, from its top left
+// corner, of |frame| into an upright |document| of |size|. The source is
+// sampled straight from |frame| in bilinear fixed point, over the output rows
+// in parallel. |document| is RGBA for RGBA frames, and BGR otherwise.
+void RectifyDocument(const cv::Mat& frame,
+                     PixelFormat format,
+                     const std::vector<cv::Point>& clockwise_points,
+                     const cv::Size& size,
+                     cv::Mat& document);
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_RECTIFIER_H_
@@ -0,0 +1,93 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document_tracker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <opencv2/imgproc.hpp>
+
+namespace example {
+
+DocumentTracker::DocumentTracker(int template_size,
+                                 int search_radius,
+                                 float minimum_confidence,
+                                 int maximum_tracked_frames)
+    : template_size_(template_size),
+      search_radius_(search_radius),
+      minimum_confidence_(minimum_confidence),
+      maximum_tracked_frames_(maximum_tracked_frames),
+      tracked_frame_count_(0) {
+}
+
+DocumentTracker::~DocumentTracker() {
+}
+
+bool DocumentTracker::Track(const cv::Mat& snapshot) {
+  std::swap(previous_gray_, gray_);
+  cv::cvtColor(snapshot, gray_, cv::COLOR_BGR2GRAY);
+  if (quad_.clockwise_points.size() != 4 ||
+      previous_gray_.size() != gray_.size() ||
+      tracked_frame_count_ >= maximum_tracked_frames_)
+    return false;
+
+  const cv::Rect frame(cv::Point(0, 0), gray_.size());
+  const int half = template_size_ / 2;
+  std::vector<cv::Point> points;
+  float confidence = 1.0f;
+  for (const auto& corner : quad_.clockwise_points) {
+    // A corner leaving the frame is handed back to the detection.
+    const cv::Rect patch(corner.x - half, corner.y - half,
+                         template_size_, template_size_);
+    if ((patch & frame) != patch)
+      return false;
+
+    const cv::Rect window =
+        cv::Rect(patch.x - search_radius_, patch.y - search_radius_,
+                 template_size_ + search_radius_ * 2,
+                 template_size_ + search_radius_ * 2) & frame;
+    cv::matchTemplate(gray_(window), previous_gray_(patch), scores_,
+                      cv::TM_CCOEFF_NORMED);
+    double score = 0.0;
+    cv::Point location;
+    cv::minMaxLoc(scores_, nullptr, &score, nullptr, &location);
+    // A flat patch has no variance to correlate, and scores 0.
+    if (score < minimum_confidence_)
+      return false;
+
+    confidence = std::min(confidence, static_cast<float>(score));
+    points.push_back(window.tl() + location + cv::Point(half, half));
+  }
+  if (!cv::isContourConvex(points))
+    return false;
+
+  quad_.clockwise_points = std::move(points);
+  quad_.source = Source::kTracking;
+  quad_.confidence = confidence;
+  tracked_frame_count_++;
+  return true;
+}
+
+void DocumentTracker::SetDetection(
+    const std::vector<cv::Point>& clockwise_points) {
+  const bool is_found = clockwise_points.size() == 4;
+  quad_.clockwise_points = clockwise_points;
+  quad_.source = is_found ? Source::kDetection : Source::kNone;
+  quad_.confidence = is_found ? 1.0f : 0.0f;
+  tracked_frame_count_ = 0;
+}
+
+}  // namespace example
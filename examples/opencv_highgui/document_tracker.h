@@ -0,0 +1,73 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_TRACKER_H_
+#define EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_TRACKER_H_
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace example {
+
+// Follows the document quad of a live capture by matching a patch around
+// every corner of the previous frame within a small window of the current
+// one. The document detection is needed again when a corner loses its match
+// or the quad stops being convex, and after |maximum_tracked_frames| in a row
+// in any case, since the matching error of every frame adds up.
+class DocumentTracker {
+ public:
+  enum class Source {
+    kNone,
+    kDetection,
+    kTracking,
+  };
+
+  struct Quad {
+    std::vector<cv::Point> clockwise_points;
+    Source source = Source::kNone;
+    // The lowest normalized correlation of the corners while tracking.
+    float confidence = 0.0f;
+  };
+
+  DocumentTracker(int template_size,
+                  int search_radius,
+                  float minimum_confidence,
+                  int maximum_tracked_frames);
+  virtual ~DocumentTracker();
+
+  // Moves the quad onto |snapshot|, and returns false if the caller should
+  // run the detection and pass its points to SetDetection() instead.
+  bool Track(const cv::Mat& snapshot);
+  void SetDetection(const std::vector<cv::Point>& clockwise_points);
+
+  const Quad& quad() const { return quad_; }
+
+ private:
+  const int template_size_;
+  const int search_radius_;
+  const float minimum_confidence_;
+  const int maximum_tracked_frames_;
+  int tracked_frame_count_;
+
+  cv::Mat previous_gray_;
+  cv::Mat gray_;
+  cv::Mat scores_;
+  Quad quad_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_DOCUMENT_TRACKER_H_
@@ -0,0 +1,117 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "face_quality_gate.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+namespace example {
+
+namespace {
+
+// Beyond this yaw or pitch the recognizer is of little use.
+constexpr float kMaximumAngle = 45.0f;
+
+// The width a face needs to be fully worth recognizing.
+constexpr float kSufficientWidthInPixels = 112.0f;
+
+// The variance of the Laplacian of a sharp face at kBlurEstimationSize.
+constexpr double kSharpLaplacianVariance = 150.0;
+constexpr int kBlurEstimationSize = 64;
+
+// The margin around a bounding box, relative to its size, kept in the crop.
+constexpr float kCropMarginRatio = 0.5f;
+
+float Clamp(float value) {
+  return std::max(0.0f, std::min(value, 1.0f));
+}
+
+float EstimatePose(const clova::Face& face) {
+  const auto& euler_angle = face.euler_angle();
+  const float angle = std::max(std::abs(euler_angle.pitch()),
+                               std::abs(euler_angle.yaw()));
+  return Clamp(1.0f - angle / kMaximumAngle);
+}
+
+float EstimateSize(const clova::Face& face) {
+  return Clamp(face.bounding_box().width() / kSufficientWidthInPixels);
+}
+
+// With the 5-point landmarks, i.e. the eyes, the nose and the corners of the
+// mouth, the nose of a frontal face sits right between the eyes. Other
+// landmark layouts leave the pose to the Euler angle alone.
+float EstimateSymmetry(const clova::Face& face) {
+  const auto& points = face.contour().points;
+  if (points.size() != 5)
+    return 1.0f;
+
+  const float eye_distance = std::abs(points[1].x() - points[0].x());
+  if (eye_distance <= 0.0f)
+    return 0.0f;
+  const float eye_center = (points[0].x() + points[1].x()) / 2.0f;
+  return Clamp(1.0f - std::abs(points[2].x() - eye_center) / eye_distance);
+}
+
+}  // namespace
+
+FaceQualityGate::FaceQualityGate(float minimum_quality)
+    : minimum_quality_(minimum_quality),
+      has_passing_face_(false) {
+}
+
+FaceQualityGate::~FaceQualityGate() {
+}
+
+float FaceQualityGate::Estimate(const cv::Mat& snapshot,
+                                const clova::Face& face) {
+  const auto& crop = GetCrop(snapshot, face);
+  if (crop.empty())
+    return 0.0f;
+
+  cv::resize(snapshot(crop), crop_buffer_,
+             cv::Size(kBlurEstimationSize, kBlurEstimationSize), 0, 0,
+             cv::INTER_AREA);
+  cv::cvtColor(crop_buffer_, gray_buffer_, cv::COLOR_BGR2GRAY);
+  cv::Laplacian(gray_buffer_, laplacian_buffer_, CV_64F);
+  cv::Scalar mean;
+  cv::Scalar standard_deviation;
+  cv::meanStdDev(laplacian_buffer_, mean, standard_deviation);
+  const float sharpness = Clamp(standard_deviation[0] * standard_deviation[0] /
+                                kSharpLaplacianVariance);
+
+  return EstimatePose(face) * EstimateSize(face) * EstimateSymmetry(face) *
+         sharpness;
+}
+
+void FaceQualityGate::Update(const std::vector<float>& qualities) {
+  has_passing_face_ = std::any_of(
+      qualities.cbegin(), qualities.cend(),
+      [this](float quality) { return Passes(quality); });
+}
+
+cv::Rect FaceQualityGate::GetCrop(const cv::Mat& snapshot,
+                                  const clova::Face& face) const {
+  const auto& box = face.bounding_box();
+  const int margin_x = box.width() * kCropMarginRatio;
+  const int margin_y = box.height() * kCropMarginRatio;
+  const cv::Rect crop(box.x() - margin_x, box.y() - margin_y,
+                      box.width() + margin_x * 2, box.height() + margin_y * 2);
+  return crop & cv::Rect(cv::Point(0, 0), snapshot.size());
+}
+
+}  // namespace example
@@ -0,0 +1,66 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_FACE_QUALITY_GATE_H_
+#define EXAMPLES_OPENCV_HIGHGUI_FACE_QUALITY_GATE_H_
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "base/face.h"
+
+namespace example {
+
+// Keeps blurry, tiny or extreme-pose faces away from the expensive per-face
+// stages the caller gates on it. The face mode of the example gates the mask
+// and the spoofing detectors, the only heavy stages it requests.
+//
+// The quality of a face comes from its Euler angle, its size, the symmetry of
+// its landmarks when they are the 5-point ones, and a Laplacian-variance blur
+// estimate on its crop, so only bounding boxes, contours and Euler angles are
+// needed to compute it. The expensive stages are requested on the next frame
+// run only if some face of the current frame passes, and only the passing
+// faces take their values, so a frame of bad faces skips them altogether.
+class FaceQualityGate {
+ public:
+  explicit FaceQualityGate(float minimum_quality);
+  virtual ~FaceQualityGate();
+
+  // Returns the quality of |face| in [0, 1]. |snapshot| must not be drawn on
+  // yet, or the overlays would count as sharpness.
+  float Estimate(const cv::Mat& snapshot, const clova::Face& face);
+
+  bool Passes(float quality) const { return quality >= minimum_quality_; }
+
+  // Takes the qualities of the faces of a frame, to decide on the next one.
+  void Update(const std::vector<float>& qualities);
+
+  // Whether the last frame had a face passing the gate.
+  bool has_passing_face() const { return has_passing_face_; }
+
+ private:
+  cv::Rect GetCrop(const cv::Mat& snapshot, const clova::Face& face) const;
+
+  const float minimum_quality_;
+  bool has_passing_face_;
+  cv::Mat gray_buffer_;
+  cv::Mat laplacian_buffer_;
+  cv::Mat crop_buffer_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_FACE_QUALITY_GATE_H_
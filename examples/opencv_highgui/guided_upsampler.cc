@@ -0,0 +1,86 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "guided_upsampler.h"
+
+#include <cassert>
+#include <cstdint>
+
+#include <opencv2/imgproc.hpp>
+
+namespace example {
+
+GuidedUpsampler::GuidedUpsampler(int radius, float epsilon)
+    : radius_(radius), epsilon_(epsilon) {
+}
+
+GuidedUpsampler::~GuidedUpsampler() {
+}
+
+const cv::Mat& GuidedUpsampler::Upsample(const cv::Mat& mask,
+                                         const cv::Mat& low_resolution_guide,
+                                         const cv::Mat& guide) {
+  assert(mask.size() == low_resolution_guide.size());
+  const cv::Size window(radius_ * 2 + 1, radius_ * 2 + 1);
+
+  low_resolution_guide.convertTo(guide_, CV_32F, 1.0 / 255);
+  mask.convertTo(mask_, CV_32F, 1.0 / 255);
+  cv::boxFilter(guide_, mean_guide_, CV_32F, window);
+  cv::boxFilter(mask_, mean_mask_, CV_32F, window);
+  cv::multiply(guide_, guide_, product_);
+  cv::boxFilter(product_, mean_guide_square_, CV_32F, window);
+  cv::multiply(guide_, mask_, product_);
+  cv::boxFilter(product_, mean_guide_mask_, CV_32F, window);
+
+  // Fits mask = a * guide + b in every window. |b| is kept in the 8-bit range
+  // so that the output needs no rescaling of the 8-bit guide.
+  a_.create(mask.size(), CV_32F);
+  b_.create(mask.size(), CV_32F);
+  for (int y = 0; y < mask.rows; ++y) {
+    const auto* mean_guide = mean_guide_.ptr<float>(y);
+    const auto* mean_mask = mean_mask_.ptr<float>(y);
+    const auto* mean_guide_square = mean_guide_square_.ptr<float>(y);
+    const auto* mean_guide_mask = mean_guide_mask_.ptr<float>(y);
+    auto* a = a_.ptr<float>(y);
+    auto* b = b_.ptr<float>(y);
+    for (int x = 0; x < mask.cols; ++x) {
+      const float variance =
+          mean_guide_square[x] - mean_guide[x] * mean_guide[x];
+      const float covariance =
+          mean_guide_mask[x] - mean_guide[x] * mean_mask[x];
+      a[x] = covariance / (variance + epsilon_);
+      b[x] = (mean_mask[x] - a[x] * mean_guide[x]) * 255;
+    }
+  }
+  cv::boxFilter(a_, mean_a_, CV_32F, window);
+  cv::boxFilter(b_, mean_b_, CV_32F, window);
+
+  cv::resize(mean_a_, upsampled_a_, guide.size(), 0, 0, cv::INTER_LINEAR);
+  cv::resize(mean_b_, upsampled_b_, guide.size(), 0, 0, cv::INTER_LINEAR);
+  upsampled_mask_.create(guide.size(), CV_8UC1);
+  cv::parallel_for_(cv::Range(0, guide.rows), [&](const cv::Range& range) {
+    for (int y = range.start; y < range.end; ++y) {
+      const auto* a = upsampled_a_.ptr<float>(y);
+      const auto* b = upsampled_b_.ptr<float>(y);
+      const auto* pixels = guide.ptr<uint8_t>(y);
+      auto* alphas = upsampled_mask_.ptr<uint8_t>(y);
+      for (int x = 0; x < guide.cols; ++x)
+        alphas[x] = cv::saturate_cast<uint8_t>(a[x] * pixels[x] + b[x]);
+    }
+  });
+  return upsampled_mask_;
+}
+
+}  // namespace example
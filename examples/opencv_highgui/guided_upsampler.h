@@ -0,0 +1,60 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_GUIDED_UPSAMPLER_H_
+#define EXAMPLES_OPENCV_HIGHGUI_GUIDED_UPSAMPLER_H_
+
+#include <opencv2/core.hpp>
+
+namespace example {
+
+// Upsamples a low resolution alpha mask to the size of its guide image with
+// the fast guided filter, so that the mask edges snap to the image edges.
+// The linear coefficients are fitted at the low resolution, and only their
+// bilinear interpolation and one multiply-add run per output pixel.
+class GuidedUpsampler {
+ public:
+  GuidedUpsampler(int radius, float epsilon);
+  virtual ~GuidedUpsampler();
+
+  // |mask| and |low_resolution_guide| are CV_8UC1 of the same size, and
+  // |guide| is the CV_8UC1 luma of the output size.
+  const cv::Mat& Upsample(const cv::Mat& mask,
+                          const cv::Mat& low_resolution_guide,
+                          const cv::Mat& guide);
+
+ private:
+  const int radius_;
+  const float epsilon_;
+
+  cv::Mat guide_;
+  cv::Mat mask_;
+  cv::Mat product_;
+  cv::Mat mean_guide_;
+  cv::Mat mean_mask_;
+  cv::Mat mean_guide_square_;
+  cv::Mat mean_guide_mask_;
+  cv::Mat a_;
+  cv::Mat b_;
+  cv::Mat mean_a_;
+  cv::Mat mean_b_;
+  cv::Mat upsampled_a_;
+  cv::Mat upsampled_b_;
+  cv::Mat upsampled_mask_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_GUIDED_UPSAMPLER_H_
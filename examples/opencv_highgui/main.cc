@@ -18,8 +18,12 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdlib>
+#include <iostream>
+#include <iterator>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <cmrc/cmrc.hpp>
@@ -37,7 +41,16 @@
 #include "face/options.h"
 #include "ocr/options.h"
 #include "sdk/clova_see.h"
+#include "sdk/measure_result.h"
+#include "combined_runner.h"
+#include "compositor.h"
+#include "document_rectifier.h"
+#include "document_tracker.h"
+#include "face_quality_gate.h"
+#include "guided_upsampler.h"
+#include "segment_propagator.h"
 #include "third_parties/range_v3/include/range/v3/view/transform.hpp"
+#include "tiled_face_detector.h"
 
 CMRC_DECLARE(resources);
 
@@ -47,12 +60,214 @@ const cv::Scalar kColorBlue(255, 0, 0, 0);
 const cv::Scalar kColorGreen(0, 255, 0, 0);
 const cv::Scalar kColorRed(0, 0, 255, 0);
 
+// A hard per-frame budget for the face pipeline, i.e. 30 fps.
+constexpr float kFrameBudgetInMilli = 33.0f;
+
+// Faces smaller than this, relative to the long side of the frame, are of no
+// interest to the example.
+constexpr float kMinimumBoundingBoxSize = 0.1f;
+
+// The detector input. A smaller one would do for kMinimumBoundingBoxSize in
+// theory, but stays out until DoResizeThresholdBenchmark() of the benchmark
+// shows that it finds the same faces.
+constexpr int kResizeThreshold = 320;
+
+// Faces of lower quality skip the recognizer, the spoofing detector and mojo.
+constexpr float kMinimumFaceQuality = 0.3f;
+
+// Frames whose long side exceeds a tile are detected tile by tile at their
+// native scale, so that distant faces in e.g. 4K frames do not vanish.
+constexpr int kTileSize = 640;
+constexpr float kTileOverlapRatio = 0.2f;
+constexpr size_t kNumberOfTileInstances = 4;
+
+// The body segmentation runs on every third frame only, and the mask is moved
+// along the block motion of the downscaled luma in between.
+constexpr int kSegmentationKeyframeInterval = 3;
+constexpr int kMotionBlockSize = 8;
+constexpr int kMotionSearchRadius = 4;
+
+// Between keyframes, the mask, kept at a quarter of the frame resolution, is
+// upsampled for the display with the guided filter of this radius at the mask
+// resolution. Keyframes show the mask of the SDK as is.
+constexpr int kGuidedFilterRadius = 2;
+constexpr float kGuidedFilterEpsilon = 1e-3f;
+
+// The document quad is tracked by matching a patch around every corner within
+// the search radius, until the weakest match falls below the confidence or
+// the quad has been tracked for the maximum number of frames.
+constexpr int kCornerTemplateSize = 31;
+constexpr int kCornerSearchRadius = 16;
+constexpr float kMinimumTrackingConfidence = 0.8f;
+constexpr int kMaximumTrackedFrames = 30;
+
+// The tracked document is shown rectified at this size, in the A4 ratio.
+const cv::Size kRectifiedDocumentSize(424, 600);
+
+// Every pipeline of the combined mode runs on an instance of these threads.
+constexpr int kNumberOfThreadsPerPipeline = 2;
+
 enum class RunType {
+  kAll,
   kBody,
   kFace,
   kOcr,
+  kTiledFace,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// class DeadlineScheduler
+
+// Drops the lowest-priority stages from |information_to_obtain| whenever the
+// predicted cost of a frame exceeds the budget. The cost of each stage is
+// learned from the MeasureResult of the frames in which it actually ran, so
+// a shed stage is scheduled again as soon as the rest of the pipeline leaves
+// enough room for it.
+class DeadlineScheduler {
+ public:
+  explicit DeadlineScheduler(float budget_in_milli);
+  virtual ~DeadlineScheduler();
+
+  uint32_t Schedule(uint32_t information_to_obtain) const;
+  void Update(uint32_t scheduled_information,
+              const clova::MeasureResult& measure_result);
+
+ private:
+  struct SheddableStage {
+    uint32_t information;
+    float clova::MeasureResult::* cost_in_milli;
+  };
+
+  // In shedding order. Mojo has no measurement of its own, so its cost stays
+  // in the base cost and it is simply the first one to go.
+  static const std::vector<SheddableStage> kSheddableStages;
+  static constexpr float kSmoothingFactor = 0.2f;
+
+  float PredictCostInMilli(uint32_t information_to_obtain) const;
+
+  const float budget_in_milli_;
+  float base_cost_in_milli_;
+  std::unordered_map<uint32_t, float> stage_costs_in_milli_;
+};
+
+const std::vector<DeadlineScheduler::SheddableStage>
+DeadlineScheduler::kSheddableStages {
+  { clova::face::Options::kMojos, nullptr },
+  { clova::face::Options::kSpoofs,
+    &clova::MeasureResult::spoofing_detector_in_milli },
+  { clova::face::Options::kMasks,
+    &clova::MeasureResult::mask_detector_in_milli },
+  { clova::face::Options::kFeatures,
+    &clova::MeasureResult::recognizer_in_milli },
 };
 
+DeadlineScheduler::DeadlineScheduler(float budget_in_milli)
+    : budget_in_milli_(budget_in_milli),
+      base_cost_in_milli_(0.0f) {
+}
+
+DeadlineScheduler::~DeadlineScheduler() {
+}
+
+uint32_t DeadlineScheduler::Schedule(uint32_t information_to_obtain) const {
+  for (const auto& stage : kSheddableStages) {
+    if (PredictCostInMilli(information_to_obtain) <= budget_in_milli_)
+      break;
+    information_to_obtain &= ~stage.information;
+  }
+  return information_to_obtain;
+}
+
+void DeadlineScheduler::Update(uint32_t scheduled_information,
+                               const clova::MeasureResult& measure_result) {
+  if (measure_result.total_fps <= 0.0f)
+    return;
+
+  const auto& smooth = [](float& average, float value) {
+    average += kSmoothingFactor * (value - average);
+  };
+
+  float base_cost_in_milli = 1000.0f / measure_result.total_fps;
+  for (const auto& stage : kSheddableStages) {
+    if (!stage.cost_in_milli || !(scheduled_information & stage.information))
+      continue;
+    const float cost_in_milli = measure_result.*stage.cost_in_milli;
+    smooth(stage_costs_in_milli_[stage.information], cost_in_milli);
+    base_cost_in_milli -= cost_in_milli;
+  }
+  smooth(base_cost_in_milli_, std::max(base_cost_in_milli, 0.0f));
+}
+
+float DeadlineScheduler::PredictCostInMilli(
+    uint32_t information_to_obtain) const {
+  float cost_in_milli = base_cost_in_milli_;
+  for (const auto& pair : stage_costs_in_milli_) {
+    if (information_to_obtain & pair.first)
+      cost_in_milli += pair.second;
+  }
+  return cost_in_milli;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class StaleAttributeCache
+
+// Keeps the last fresh mask and spoof values per tracking ID, so that a face
+// whose stages were shed, or gated out for its quality, can still be drawn
+// with a value marked as stale. A face has no value until one was fresh.
+class StaleAttributeCache {
+ public:
+  struct Attributes {
+    clova::Mask mask = false;
+    clova::Spoof spoof = false;
+    bool is_mask_fresh = false;
+    bool is_spoof_fresh = false;
+    bool has_mask = false;
+    bool has_spoof = false;
+  };
+
+  // Takes the values in |fresh_information| from |face| and keeps the last
+  // ones for the others.
+  Attributes Update(clova::TrackingID tracking_id,
+                    const clova::Face& face,
+                    uint32_t fresh_information);
+
+  // Forgets the faces missing from |faces|, as tracking IDs are not reused.
+  void Retain(const std::vector<clova::Face>& faces);
+
+ private:
+  std::unordered_map<clova::TrackingID, Attributes> attributes_;
+};
+
+StaleAttributeCache::Attributes StaleAttributeCache::Update(
+    clova::TrackingID tracking_id,
+    const clova::Face& face,
+    uint32_t fresh_information) {
+  auto& attributes = attributes_[tracking_id];
+  attributes.is_mask_fresh = fresh_information & clova::face::Options::kMasks;
+  attributes.is_spoof_fresh =
+      fresh_information & clova::face::Options::kSpoofs;
+  if (attributes.is_mask_fresh) {
+    attributes.mask = face.mask();
+    attributes.has_mask = true;
+  }
+  if (attributes.is_spoof_fresh) {
+    attributes.spoof = face.spoof();
+    attributes.has_spoof = true;
+  }
+  return attributes;
+}
+
+void StaleAttributeCache::Retain(const std::vector<clova::Face>& faces) {
+  for (auto iterator = attributes_.begin(); iterator != attributes_.end();) {
+    const bool is_present = std::any_of(
+        faces.cbegin(), faces.cend(),
+        [&iterator](const clova::Face& face) {
+          return face.tracking_id() == iterator->first;
+        });
+    iterator = is_present ? std::next(iterator) : attributes_.erase(iterator);
+  }
+}
+
 std::string Format(const char* format, ...) {
   va_list arguments;
   va_start(arguments, format);
@@ -101,12 +316,17 @@ bool InitializeVideoCapture(cv::VideoCapture& capturer,
   return true;
 }
 
-cv::Mat Capture(cv::VideoCapture& capturer, bool is_selfie_facing = false) {
-  cv::Mat snapshot;
+// Captures into |snapshot|, whose buffer is reused as long as the size of the
+// captured frames does not change.
+bool Capture(cv::VideoCapture& capturer,
+             cv::Mat& snapshot,
+             bool is_selfie_facing = false) {
   capturer >> snapshot;
+  if (snapshot.empty())
+    return false;
   if (is_selfie_facing)
     cv::flip(snapshot, snapshot, 1);
-  return snapshot;
+  return true;
 }
 
 float CalculateCosineSimilarity(const std::vector<clova::Face>& faces) {
@@ -133,35 +353,24 @@ void DrawText(cv::Mat& canvas, const std::string& text, int line_number) {
               cv::FONT_HERSHEY_SIMPLEX, 0.6, kColorRed);
 }
 
-void DrawSegment(cv::Mat& canvas, const clova::body::Result& result) {
-  const auto& segment = result.segment();
-  if (segment.empty())
+// Writes |canvas| with its background replaced along |segment| into |output|,
+// which may be |canvas| itself.
+void DrawSegment(const cv::Mat& canvas,
+                 const cv::Mat& segment,
+                 cv::Mat& output) {
+  if (segment.empty()) {
+    canvas.copyTo(output);
     return;
-
-  assert(canvas.total() == segment.size());
-  const int channel_count = canvas.channels();
-  const int pixel_count = canvas.cols * canvas.rows * channel_count;
-  auto* canvas_pixels = canvas.ptr<uint8_t>();
+  }
 
   static const cv::Mat background =
       LoadEmbeddedImage("background.png", canvas.size());
-  assert(canvas.size() == background.size());
-  auto* background_pixels = background.ptr<uint8_t>();
-
-  for (int pixel_index = 0, alpha_index = 0;
-       pixel_index < pixel_count;
-       pixel_index += channel_count, alpha_index += 1) {
-    const float alpha = segment[alpha_index] / 255.0f;
-    for (int channel_index = 0;
-         channel_index < channel_count;
-         channel_index++) {
-        float value =
-            canvas_pixels[pixel_index + channel_index] * alpha +
-            background_pixels[pixel_index + channel_index] * (1 - alpha);
-        value = std::max(std::min(value, 255.f), 0.f);
-        canvas_pixels[pixel_index + channel_index] = value;
-    }
-  }
+  example::Composite(canvas, segment, background,
+                     example::PixelFormat::kBGR_888, output);
+}
+
+void DrawSegment(cv::Mat& canvas, const cv::Mat& segment) {
+  DrawSegment(canvas, segment, canvas);
 }
 
 void DrawSimilarity(cv::Mat& canvas, const std::vector<clova::Face>& faces) {
@@ -193,23 +402,46 @@ void DrawTrackingID(cv::Mat& canvas, const clova::Face& face) {
               cv::FONT_HERSHEY_SIMPLEX, 0.6, kColorRed);
 }
 
-void DrawMask(cv::Mat& canvas, const clova::Face& face) {
-  cv::putText(canvas, Format("mask=%s", face.mask() ? "yes" : "no"),
+void DrawMask(cv::Mat& canvas,
+              const clova::Face& face,
+              const StaleAttributeCache::Attributes& attributes) {
+  const std::string& text = attributes.has_mask
+      ? Format("mask=%s%s", attributes.mask ? "yes" : "no",
+               attributes.is_mask_fresh ? "" : " (stale)")
+      : "mask=unknown";
+  cv::putText(canvas, text,
               ToCvPoint(face.bounding_box().origin() - clova::Vector2d(0, 18)),
               cv::FONT_HERSHEY_SIMPLEX, 0.6, kColorRed);
 }
 
-void DrawSpoof(cv::Mat& canvas, const clova::Face& face) {
-  if (face.spoof())
+void DrawSpoof(cv::Mat& canvas,
+               const clova::Face& face,
+               const StaleAttributeCache::Attributes& attributes) {
+  if (attributes.has_spoof && attributes.spoof)
     cv::rectangle(canvas, ToCvRect(face.bounding_box()), kColorBlue, 3);
-  cv::putText(canvas, Format("spoof=%s", face.spoof() ? "yes" : "no"),
+  const std::string& text = attributes.has_spoof
+      ? Format("spoof=%s%s", attributes.spoof ? "yes" : "no",
+               attributes.is_spoof_fresh ? "" : " (stale)")
+      : "spoof=unknown";
+  cv::putText(canvas, text,
               ToCvPoint(face.bounding_box().origin() - clova::Vector2d(0, 36)),
               cv::FONT_HERSHEY_SIMPLEX, 0.6, kColorRed);
 }
 
-void DrawDocument(cv::Mat& canvas, const clova::ocr::Result& result) {
-  cv::polylines(canvas, ToCvPoints(result.document().clockwise_points()), true,
-                kColorRed, 2);
+void DrawDocument(cv::Mat& canvas,
+                  const example::DocumentTracker::Quad& quad) {
+  using Source = example::DocumentTracker::Source;
+  cv::polylines(canvas, quad.clockwise_points, true, kColorRed, 2);
+  if (quad.source == Source::kTracking)
+    DrawText(canvas, Format("document=tracked (%.2f)", quad.confidence), 0);
+  else if (quad.source == Source::kDetection)
+    DrawText(canvas, "document=detected", 0);
+}
+
+void DrawQuality(cv::Mat& canvas, const clova::Face& face, float quality) {
+  cv::putText(canvas, Format("quality=%.2f", quality),
+              ToCvPoint(face.bounding_box().origin() - clova::Vector2d(0, 54)),
+              cv::FONT_HERSHEY_SIMPLEX, 0.6, kColorRed);
 }
 
 void DrawFps(cv::Mat& canvas, float fps) {
@@ -218,40 +450,197 @@ void DrawFps(cv::Mat& canvas, float fps) {
 }
 
 void DoRunForBody(clova::ClovaSee& clova_see, cv::Mat& snapshot) {
+  static example::SegmentPropagator segment_propagator(
+      kSegmentationKeyframeInterval,
+      kMotionBlockSize,
+      kMotionSearchRadius);
+  static example::GuidedUpsampler guided_upsampler(kGuidedFilterRadius,
+                                                   kGuidedFilterEpsilon);
+
   const auto& options = clova::body::OptionsBuilder().Build();
-  const auto& result = clova_see.Run(ToFrame(snapshot), options);
-  DrawSegment(snapshot, result);
+  const auto& segment = segment_propagator.Run(clova_see, snapshot, options);
+  if (segment_propagator.is_keyframe()) {
+    DrawSegment(snapshot, segment_propagator.keyframe_segment());
+    return;
+  }
+  DrawSegment(snapshot,
+              guided_upsampler.Upsample(segment,
+                                        segment_propagator.luma(),
+                                        segment_propagator.gray()));
 }
 
 void DoRunForFace(clova::ClovaSee& clova_see, cv::Mat& snapshot) {
+  // The expensive per-face stages are requested only while the quality gate
+  // lets some face through, and only the faces it lets through take them.
+  constexpr uint32_t kGatedInformation = clova::face::Options::kMasks |
+                                         clova::face::Options::kSpoofs;
+  static DeadlineScheduler deadline_scheduler(kFrameBudgetInMilli);
+  static StaleAttributeCache stale_attribute_cache;
+  static example::FaceQualityGate face_quality_gate(kMinimumFaceQuality);
+
+  const uint32_t scheduled_information = deadline_scheduler.Schedule(
+      clova::face::Options::kContours |
+      clova::face::Options::kEulerAngles |
+      clova::face::Options::kMasks |
+      clova::face::Options::kTrackingIDs |
+      clova::face::Options::kSpoofs);
+  const uint32_t information_to_obtain =
+      (face_quality_gate.has_passing_face()
+          ? scheduled_information
+          : scheduled_information & ~kGatedInformation) |
+      clova::face::Options::kEulerAngles;
   const auto& options = clova::face::OptionsBuilder()
       .SetBoundingBoxThreshold(0.7f)
-      .SetInformationToObtain(clova::face::Options::kContours |
-                              clova::face::Options::kEulerAngles |
-                              clova::face::Options::kMasks |
-                              clova::face::Options::kTrackingIDs |
-                              clova::face::Options::kSpoofs)
-      .SetMinimumBoundingBoxSize(0.1f)
-      .SetResizeThreshold(320)
+      .SetInformationToObtain(information_to_obtain)
+      .SetMinimumBoundingBoxSize(kMinimumBoundingBoxSize)
+      .SetResizeThreshold(kResizeThreshold)
       .SetSmoothingContour(true)
       .SetSmoothingRect(false)
       .Build();
-  const auto& faces = clova_see.Run(ToFrame(snapshot), options).faces();
+  const auto& result = clova_see.Run(ToFrame(snapshot), options);
+  const auto& faces = result.faces();
+  deadline_scheduler.Update(information_to_obtain,
+                            clova_see.GetMeasureResult());
+
+  // The qualities are estimated before anything is drawn, as the overlays
+  // would add to the sharpness of the crops.
+  std::vector<float> qualities;
+  for (const auto& face : faces)
+    qualities.push_back(face_quality_gate.Estimate(snapshot, face));
+
   DrawSimilarity(snapshot, faces);
-  for (const auto& face : faces) {
+  for (size_t index = 0; index < faces.size(); ++index) {
+    const auto& face = faces[index];
+    const float quality = qualities[index];
+    const uint32_t fresh_information = face_quality_gate.Passes(quality)
+        ? information_to_obtain
+        : information_to_obtain & ~kGatedInformation;
+    const auto& attributes = stale_attribute_cache.Update(
+        face.tracking_id(), face, fresh_information);
     DrawBoundingBox(snapshot, face);
     DrawContour(snapshot, face);
     DrawEulerAngle(snapshot, face);
     DrawTrackingID(snapshot, face);
-    DrawMask(snapshot, face);
-    DrawSpoof(snapshot, face);
+    DrawMask(snapshot, face, attributes);
+    DrawSpoof(snapshot, face, attributes);
+    DrawQuality(snapshot, face, quality);
+  }
+  face_quality_gate.Update(qualities);
+  stale_attribute_cache.Retain(faces);
+}
+
+void DoRunForAll(cv::Mat& snapshot) {
+  static example::CombinedRunner combined_runner(kNumberOfThreadsPerPipeline);
+
+  const auto& face_options = clova::face::OptionsBuilder()
+      .SetBoundingBoxThreshold(0.7f)
+      .SetInformationToObtain(clova::face::Options::kContours)
+      .SetMinimumBoundingBoxSize(kMinimumBoundingBoxSize)
+      .SetResizeThreshold(kResizeThreshold)
+      .Build();
+  const auto& body_options = clova::body::OptionsBuilder().Build();
+
+  // The face pipeline still reads the snapshot while the body stage
+  // composites, so the composition goes into a buffer of its own.
+  static cv::Mat composited;
+  const auto& composite = [&snapshot](const clova::body::Result& body) {
+    const auto& segment = body.segment();
+    if (segment.size() != snapshot.total()) {
+      snapshot.copyTo(composited);
+      return;
+    }
+    DrawSegment(snapshot,
+                cv::Mat(snapshot.size(), CV_8UC1,
+                        const_cast<uint8_t*>(segment.data())),
+                composited);
+  };
+  const auto& result = combined_runner.Run(
+      ToFrame(snapshot), face_options, body_options, nullptr, composite);
+
+  composited.copyTo(snapshot);
+  for (const auto& face : result.face.faces()) {
+    DrawBoundingBox(snapshot, face);
+    DrawContour(snapshot, face);
+  }
+}
+
+void DoRunForTiledFace(cv::Mat& snapshot) {
+  static example::TiledFaceDetector tiled_face_detector(
+      kTileSize, kTileOverlapRatio, kNumberOfTileInstances);
+  const auto& boxes = tiled_face_detector.Detect(snapshot);
+  for (const auto& box : boxes)
+    cv::rectangle(snapshot, box, kColorRed, 2);
+  DrawText(snapshot, Format("faces=%zu", boxes.size()), 0);
+}
+
+// Times Composite() on random 720p frames of every pixel format, and checks
+// it against CompositeScalar(), which it has to match exactly.
+void CheckCompositor() {
+  constexpr int kRepeatCount = 50;
+  const cv::Size size(1280, 720);
+  cv::Mat alpha(size, CV_8UC1);
+  cv::randu(alpha, cv::Scalar::all(0), cv::Scalar::all(256));
+
+  const struct {
+    example::PixelFormat format;
+    const char* name;
+    int type;
+    cv::Size size;
+  } kLayouts[] = {
+    { example::PixelFormat::kBGR_888, "BGR_888", CV_8UC3, size },
+    { example::PixelFormat::kRGBA_8888, "RGBA_8888", CV_8UC4, size },
+    { example::PixelFormat::kNV21, "NV21", CV_8UC1,
+      cv::Size(size.width, size.height * 3 / 2) },
+  };
+  for (const auto& layout : kLayouts) {
+    cv::Mat foreground(layout.size, layout.type);
+    cv::Mat background(layout.size, layout.type);
+    cv::randu(foreground, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::randu(background, cv::Scalar::all(0), cv::Scalar::all(256));
+
+    cv::Mat output;
+    example::Composite(foreground, alpha, background, layout.format, output);
+    float elapsed_in_milli = 0.0f;
+    measure_in_milli(elapsed_in_milli) {
+      for (int count = 0; count < kRepeatCount; ++count) {
+        example::Composite(foreground, alpha, background, layout.format,
+                           output);
+      }
+    }
+
+    cv::Mat expected;
+    example::CompositeScalar(foreground, alpha, background, layout.format,
+                             expected);
+    std::cout << Format("Composite %-9s %dx%d: %.3fms, max error %.0f",
+                        layout.name, size.width, size.height,
+                        elapsed_in_milli / kRepeatCount,
+                        cv::norm(output, expected, cv::NORM_INF))
+              << std::endl;
   }
 }
 
 void DoRunForOcr(clova::ClovaSee& clova_see, cv::Mat& snapshot) {
-  const auto& options = clova::ocr::OptionsBuilder().Build();
-  const auto& result = clova_see.Run(ToFrame(snapshot), options);
-  DrawDocument(snapshot, result);
+  static example::DocumentTracker document_tracker(kCornerTemplateSize,
+                                                   kCornerSearchRadius,
+                                                   kMinimumTrackingConfidence,
+                                                   kMaximumTrackedFrames);
+
+  if (!document_tracker.Track(snapshot)) {
+    const auto& options = clova::ocr::OptionsBuilder().Build();
+    const auto& result = clova_see.Run(ToFrame(snapshot), options);
+    document_tracker.SetDetection(
+        ToCvPoints(result.document().clockwise_points()));
+  }
+
+  const auto& quad = document_tracker.quad();
+  if (quad.source != example::DocumentTracker::Source::kNone) {
+    static cv::Mat document;
+    example::RectifyDocument(snapshot, example::PixelFormat::kBGR_888,
+                             quad.clockwise_points, kRectifiedDocumentSize,
+                             document);
+    cv::imshow("Document", document);
+  }
+  DrawDocument(snapshot, quad);
 }
 
 }  // namespace
@@ -273,34 +662,47 @@ int main(int argc, char* argv[]) {
   if (!InitializeVideoCapture(video_capture, has_option ? argv[1] : ""))
     return EXIT_FAILURE;
 
+  cv::Mat snapshot;
   while (!quit_requested) {
-    auto snapshot = Capture(video_capture, is_selfie_facing);
-    if (snapshot.empty())
+    if (!Capture(video_capture, snapshot, is_selfie_facing))
       break;
 
     static float fps = 0.0f;
     measure_in_fps(fps) {
-      if (run_type == RunType::kBody) {
+      if (run_type == RunType::kAll) {
+        DoRunForAll(snapshot);
+      } else if (run_type == RunType::kBody) {
         DoRunForBody(clova_see, snapshot);
       } else if (run_type == RunType::kFace) {
         DoRunForFace(clova_see, snapshot);
       } else if (run_type == RunType::kOcr) {
         DoRunForOcr(clova_see, snapshot);
+      } else if (run_type == RunType::kTiledFace) {
+        DoRunForTiledFace(snapshot);
       }
     }
     DrawFps(snapshot, fps);
 
     cv::imshow("OpenCV HighGui Example", snapshot);
     switch (cv::waitKey(20)) {
+      case 'a':
+        run_type = RunType::kAll;
+        continue;
       case 'b':
         run_type = RunType::kBody;
         continue;
+      case 'c':
+        CheckCompositor();
+        continue;
       case 'f':
         run_type = RunType::kFace;
         continue;
       case 'o':
         run_type = RunType::kOcr;
         continue;
+      case 't':
+        run_type = RunType::kTiledFace;
+        continue;
       case 27:  // ESC
         quit_requested = true;
         break;
@@ -0,0 +1,30 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_PIXEL_FORMAT_H_
+#define EXAMPLES_OPENCV_HIGHGUI_PIXEL_FORMAT_H_
+
+namespace example {
+
+// Layouts of the cv::Mat frames handled by the example's image kernels.
+enum class PixelFormat {
+  kBGR_888,    // CV_8UC3 of the frame size.
+  kRGBA_8888,  // CV_8UC4 of the frame size.
+  kNV21,       // CV_8UC1 of the frame width and 3/2 of the frame height.
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_PIXEL_FORMAT_H_
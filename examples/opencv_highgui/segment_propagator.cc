@@ -0,0 +1,236 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "segment_propagator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+#include <opencv2/imgproc.hpp>
+
+#include "base/frame.h"
+
+namespace example {
+
+namespace {
+
+// The motion is estimated, and the mask is kept, at this downscaling factor.
+constexpr int kScale = 4;
+
+// A block whose mean absolute difference without moving is at most this is
+// taken as static, which spares the search for most of the background.
+constexpr int kStaticBlockThreshold = 2;
+
+// A keyframe segments the extent of the last mask, padded by this ratio of its
+// size on each side, and the whole frame at every kFullFrameKeyframeInterval.
+constexpr float kRegionOfInterestMargin = 0.25f;
+constexpr int kFullFrameKeyframeInterval = 5;
+
+// The region is never smaller than this ratio of the frame on either side,
+// so that a few stray pixels of the mask do not shrink it to nothing.
+constexpr float kMinimumRegionOfInterestRatio = 0.25f;
+
+// Pixels of the mask above this alpha make up its extent.
+constexpr double kMinimumAlpha = 127.0;
+
+int GetSad(const cv::Mat& previous,
+           const cv::Mat& current,
+           const cv::Rect& block,
+           int dx,
+           int dy) {
+  int sad = 0;
+  for (int y = block.y; y < block.y + block.height; ++y) {
+    const auto* current_row = current.ptr<uint8_t>(y);
+    const auto* previous_row = previous.ptr<uint8_t>(y + dy);
+    for (int x = block.x; x < block.x + block.width; ++x)
+      sad += std::abs(current_row[x] - previous_row[x + dx]);
+  }
+  return sad;
+}
+
+}  // namespace
+
+SegmentPropagator::SegmentPropagator(int keyframe_interval,
+                                     int block_size,
+                                     int search_radius)
+    : keyframe_interval_(std::max(keyframe_interval, 1)),
+      block_size_(block_size),
+      search_radius_(search_radius),
+      frame_index_(0),
+      keyframe_index_(0),
+      is_keyframe_(true) {
+}
+
+SegmentPropagator::~SegmentPropagator() {
+}
+
+int SegmentPropagator::scale() const {
+  return kScale;
+}
+
+const cv::Mat& SegmentPropagator::Run(clova::ClovaSee& clova_see,
+                                      const cv::Mat& snapshot,
+                                      const clova::body::Options& options) {
+  std::swap(previous_luma_, luma_);
+  cv::cvtColor(snapshot, gray_buffer_, cv::COLOR_BGR2GRAY);
+  cv::resize(gray_buffer_, luma_,
+             cv::Size(snapshot.cols / kScale, snapshot.rows / kScale), 0, 0,
+             cv::INTER_AREA);
+
+  is_keyframe_ = frame_index_ % keyframe_interval_ == 0 ||
+                 segment_.size() != luma_.size() ||
+                 previous_luma_.size() != luma_.size();
+  frame_index_++;
+
+  if (is_keyframe_)
+    Segment(clova_see, snapshot, options);
+  else
+    Propagate();
+  return segment_;
+}
+
+void SegmentPropagator::Segment(clova::ClovaSee& clova_see,
+                                const cv::Mat& snapshot,
+                                const clova::body::Options& options) {
+  // The region is segmented at the source resolution. The returned mask is
+  // shown as is, and downscaled to the mask resolution only to be propagated.
+  // The frame has no stride, so a region narrower than the snapshot is copied
+  // into a continuous buffer.
+  const cv::Rect region_of_interest = GetRegionOfInterest();
+  const bool is_right_end = region_of_interest.br().x == luma_.cols;
+  const bool is_bottom_end = region_of_interest.br().y == luma_.rows;
+  const cv::Rect source(
+      region_of_interest.x * kScale,
+      region_of_interest.y * kScale,
+      is_right_end ? snapshot.cols - region_of_interest.x * kScale
+                   : region_of_interest.width * kScale,
+      is_bottom_end ? snapshot.rows - region_of_interest.y * kScale
+                    : region_of_interest.height * kScale);
+  cv::Mat input = snapshot(source);
+  if (!input.isContinuous()) {
+    input.copyTo(region_of_interest_buffer_);
+    input = region_of_interest_buffer_;
+  }
+
+  const auto& result = clova_see.Run(
+      clova::Frame(input.data, input.cols, input.rows,
+                   clova::Frame::Format::kBGR_888),
+      options);
+  const auto& segment = result.segment();
+  keyframe_segment_.create(snapshot.size(), CV_8UC1);
+  keyframe_segment_.setTo(cv::Scalar(0));
+  segment_.create(luma_.size(), CV_8UC1);
+  segment_.setTo(cv::Scalar(0));
+  if (segment.size() != input.total())
+    return;
+  const cv::Mat mask(input.size(), CV_8UC1,
+                     const_cast<uint8_t*>(segment.data()));
+  mask.copyTo(keyframe_segment_(source));
+  cv::Mat destination = segment_(region_of_interest);
+  cv::resize(mask, destination, region_of_interest.size(), 0, 0,
+             cv::INTER_AREA);
+}
+
+cv::Rect SegmentPropagator::GetRegionOfInterest() {
+  const cv::Rect frame(cv::Point(0, 0), luma_.size());
+  if (keyframe_index_++ % kFullFrameKeyframeInterval == 0 ||
+      segment_.size() != luma_.size())
+    return frame;
+
+  cv::Mat foreground;
+  cv::threshold(segment_, foreground, kMinimumAlpha, 255, cv::THRESH_BINARY);
+  const cv::Rect extent = cv::boundingRect(foreground);
+  if (extent.empty())
+    return frame;
+
+  const int margin_x = static_cast<int>(extent.width * kRegionOfInterestMargin);
+  const int margin_y =
+      static_cast<int>(extent.height * kRegionOfInterestMargin);
+  const int width = std::min(
+      std::max(extent.width + margin_x * 2,
+               static_cast<int>(frame.width * kMinimumRegionOfInterestRatio)),
+      frame.width);
+  const int height = std::min(
+      std::max(extent.height + margin_y * 2,
+               static_cast<int>(frame.height * kMinimumRegionOfInterestRatio)),
+      frame.height);
+  // Centered on the extent, and moved inside the frame rather than clipped so
+  // that it keeps its size.
+  const int x = std::max(
+      std::min(extent.x + extent.width / 2 - width / 2, frame.width - width),
+      0);
+  const int y = std::max(
+      std::min(extent.y + extent.height / 2 - height / 2,
+               frame.height - height),
+      0);
+  return cv::Rect(x, y, width, height);
+}
+
+// Finds, for every block of the downscaled luma, the displacement within
+// |search_radius_| that best matches the previous luma, and moves the
+// corresponding block of the mask along with it.
+void SegmentPropagator::Propagate() {
+  propagated_segment_.create(segment_.size(), CV_8UC1);
+  const int block_rows = (luma_.rows + block_size_ - 1) / block_size_;
+  const int block_columns = (luma_.cols + block_size_ - 1) / block_size_;
+
+  cv::parallel_for_(cv::Range(0, block_rows), [&](const cv::Range& range) {
+    for (int block_row = range.start; block_row < range.end; ++block_row) {
+      for (int block_column = 0; block_column < block_columns;
+           ++block_column) {
+        const cv::Rect block(block_column * block_size_,
+                             block_row * block_size_,
+                             std::min(block_size_,
+                                      luma_.cols - block_column * block_size_),
+                             std::min(block_size_,
+                                      luma_.rows - block_row * block_size_));
+
+        int best_dx = 0;
+        int best_dy = 0;
+        int best_sad = GetSad(previous_luma_, luma_, block, 0, 0);
+        if (best_sad > kStaticBlockThreshold * block.area()) {
+          for (int dy = -search_radius_; dy <= search_radius_; ++dy) {
+            if (block.y + dy < 0 || block.br().y + dy > luma_.rows)
+              continue;
+            for (int dx = -search_radius_; dx <= search_radius_; ++dx) {
+              if (block.x + dx < 0 || block.br().x + dx > luma_.cols)
+                continue;
+              const int sad = GetSad(previous_luma_, luma_, block, dx, dy);
+              if (sad < best_sad) {
+                best_sad = sad;
+                best_dx = dx;
+                best_dy = dy;
+              }
+            }
+          }
+        }
+
+        const cv::Rect source =
+            (block + cv::Point(best_dx, best_dy)) &
+            cv::Rect(cv::Point(0, 0), segment_.size());
+        if (source.size() == block.size())
+          segment_(source).copyTo(propagated_segment_(block));
+        else
+          segment_(block).copyTo(propagated_segment_(block));
+      }
+    }
+  });
+
+  std::swap(segment_, propagated_segment_);
+}
+
+}  // namespace example
@@ -0,0 +1,79 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_SEGMENT_PROPAGATOR_H_
+#define EXAMPLES_OPENCV_HIGHGUI_SEGMENT_PROPAGATOR_H_
+
+#include <opencv2/core.hpp>
+
+#include "body/options.h"
+#include "sdk/clova_see.h"
+
+namespace example {
+
+// Runs portrait segmentation on a video every |keyframe_interval| frames only,
+// and propagates the last mask to the frames in between along the motion of
+// the luma channel, estimated by block matching on a downscaled copy.
+// A keyframe segments only the padded extent of the last mask, and falls back
+// to the whole frame periodically to pick up people entering the scene. The
+// mask is kept at the resolution of the downscaled luma throughout, and a
+// keyframe also keeps the mask of the SDK at the size of the snapshot.
+class SegmentPropagator {
+ public:
+  SegmentPropagator(int keyframe_interval, int block_size, int search_radius);
+  virtual ~SegmentPropagator();
+
+  // Returns the alpha mask of |snapshot|, a CV_8UC1 of the size of luma(),
+  // that is, |snapshot| downscaled by scale().
+  const cv::Mat& Run(clova::ClovaSee& clova_see,
+                     const cv::Mat& snapshot,
+                     const clova::body::Options& options);
+
+  bool is_keyframe() const { return is_keyframe_; }
+  // The mask of the last keyframe, a CV_8UC1 of the size of the snapshot, to
+  // be shown instead of upsampling the result of Run() on keyframes.
+  const cv::Mat& keyframe_segment() const { return keyframe_segment_; }
+  int scale() const;
+  // The gray scale of the last snapshot, and its downscaled copy.
+  const cv::Mat& gray() const { return gray_buffer_; }
+  const cv::Mat& luma() const { return luma_; }
+
+ private:
+  void Segment(clova::ClovaSee& clova_see,
+               const cv::Mat& snapshot,
+               const clova::body::Options& options);
+  void Propagate();
+  cv::Rect GetRegionOfInterest();
+
+  const int keyframe_interval_;
+  const int block_size_;
+  const int search_radius_;
+  int frame_index_;
+  int keyframe_index_;
+  bool is_keyframe_;
+
+  // Luma of the previous and the current frames, downscaled by scale().
+  cv::Mat previous_luma_;
+  cv::Mat luma_;
+  cv::Mat gray_buffer_;
+  cv::Mat region_of_interest_buffer_;
+  cv::Mat segment_;
+  cv::Mat propagated_segment_;
+  cv::Mat keyframe_segment_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_SEGMENT_PROPAGATOR_H_
@@ -0,0 +1,146 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stage_graph.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace example {
+
+struct StageGraph::Execution {
+  std::vector<bool> is_reachable;
+  // The dependencies left to finish, per stage.
+  std::vector<size_t> pending_counts;
+  std::vector<bool> is_skipped;
+  size_t unfinished_count = 0;
+  std::exception_ptr exception;
+  std::mutex mutex;
+  std::condition_variable condition;
+};
+
+StageGraph::StageGraph(size_t number_of_workers)
+    : worker_pool_(number_of_workers) {
+}
+
+StageGraph::~StageGraph() {
+}
+
+void StageGraph::Add(const std::string& name,
+                     const std::vector<std::string>& dependencies,
+                     Stage stage) {
+  assert(indices_.count(name) == 0);
+  Node node;
+  for (const auto& dependency : dependencies) {
+    assert(indices_.count(dependency) == 1);
+    node.dependencies.push_back(indices_.at(dependency));
+    nodes_[node.dependencies.back()].dependents.push_back(nodes_.size());
+  }
+  node.stage = std::move(stage);
+  indices_[name] = nodes_.size();
+  nodes_.push_back(std::move(node));
+}
+
+void StageGraph::Run(const std::vector<std::string>& targets) {
+  Execution execution;
+  execution.is_reachable = GetReachableNodes(targets);
+  execution.pending_counts.resize(nodes_.size());
+  execution.is_skipped.resize(nodes_.size(), false);
+  std::vector<size_t> ready_nodes;
+  for (size_t index = 0; index < nodes_.size(); ++index) {
+    if (!execution.is_reachable[index])
+      continue;
+
+    // The dependencies of a reachable stage are all reachable.
+    execution.pending_counts[index] = nodes_[index].dependencies.size();
+    ++execution.unfinished_count;
+    if (nodes_[index].dependencies.empty())
+      ready_nodes.push_back(index);
+  }
+
+  for (const auto index : ready_nodes)
+    Schedule(index, execution);
+
+  std::unique_lock<std::mutex> lock(execution.mutex);
+  execution.condition.wait(lock, [&execution] {
+    return execution.unfinished_count == 0;
+  });
+  if (execution.exception)
+    std::rethrow_exception(execution.exception);
+}
+
+void StageGraph::Schedule(size_t index, Execution& execution) {
+  worker_pool_.Submit([this, index, &execution] {
+    bool is_skipped = false;
+    {
+      std::lock_guard<std::mutex> lock(execution.mutex);
+      is_skipped = execution.is_skipped[index];
+    }
+    std::exception_ptr exception;
+    if (!is_skipped) {
+      try {
+        nodes_[index].stage();
+      } catch (...) {
+        exception = std::current_exception();
+      }
+    }
+
+    // Run returns as soon as the count drops to zero, so |execution| is left
+    // alone once the lock is released.
+    std::lock_guard<std::mutex> lock(execution.mutex);
+    const bool is_failed = is_skipped || exception;
+    if (exception && !execution.exception)
+      execution.exception = std::move(exception);
+    // Dropped under the lock too, as Run may rethrow as soon as it is free.
+    exception = nullptr;
+    for (const auto dependent : nodes_[index].dependents) {
+      if (!execution.is_reachable[dependent])
+        continue;
+      if (is_failed)
+        execution.is_skipped[dependent] = true;
+      if (--execution.pending_counts[dependent] == 0)
+        Schedule(dependent, execution);
+    }
+    if (--execution.unfinished_count == 0)
+      execution.condition.notify_all();
+  });
+}
+
+std::vector<bool> StageGraph::GetReachableNodes(
+    const std::vector<std::string>& targets) const {
+  std::vector<bool> is_reachable(nodes_.size(), false);
+  std::vector<size_t> pending;
+  for (const auto& target : targets) {
+    assert(indices_.count(target) == 1);
+    pending.push_back(indices_.at(target));
+  }
+
+  while (!pending.empty()) {
+    const size_t index = pending.back();
+    pending.pop_back();
+    if (is_reachable[index])
+      continue;
+
+    is_reachable[index] = true;
+    for (const auto dependency : nodes_[index].dependencies)
+      pending.push_back(dependency);
+  }
+  return is_reachable;
+}
+
+}  // namespace example
@@ -0,0 +1,71 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_STAGE_GRAPH_H_
+#define EXAMPLES_OPENCV_HIGHGUI_STAGE_GRAPH_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "worker_pool.h"
+
+namespace example {
+
+// Runs named stages along their declared dependencies on a pool of workers
+// that lives as long as the graph. Only the stages the requested targets
+// depend on are scheduled, each as soon as the last of its dependencies is
+// done, so that independent stages run in parallel and no worker is held
+// waiting for a dependency. A stage whose dependency threw is skipped, and
+// Run rethrows the first exception once all the scheduled stages are over.
+class StageGraph {
+ public:
+  using Stage = std::function<void()>;
+
+  // |number_of_workers| bounds the stages running at once.
+  explicit StageGraph(size_t number_of_workers);
+  virtual ~StageGraph();
+
+  // The dependencies must have been added before, which keeps the graph
+  // acyclic and the insertion order topological.
+  void Add(const std::string& name,
+           const std::vector<std::string>& dependencies,
+           Stage stage);
+
+  void Run(const std::vector<std::string>& targets);
+
+ private:
+  struct Node {
+    std::vector<size_t> dependencies;
+    std::vector<size_t> dependents;
+    Stage stage;
+  };
+
+  // The progress of a Run, shared by its stages.
+  struct Execution;
+
+  std::vector<bool> GetReachableNodes(
+      const std::vector<std::string>& targets) const;
+  void Schedule(size_t index, Execution& execution);
+
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, size_t> indices_;
+  WorkerPool worker_pool_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_STAGE_GRAPH_H_
@@ -0,0 +1,196 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tiled_face_detector.h"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+#include "base/face.h"
+#include "base/frame.h"
+
+namespace example {
+
+namespace {
+
+// Boxes overlapping more than this, either by IoU or relative to the smaller
+// one, are taken as the same face. The latter catches a face that a tile cut
+// in half.
+constexpr float kIouThreshold = 0.3f;
+constexpr float kContainmentThreshold = 0.6f;
+
+clova::face::Options NewOptions(int resize_threshold) {
+  return clova::face::OptionsBuilder()
+      .SetBoundingBoxThreshold(0.7f)
+      .SetInformationToObtain(clova::face::Options::kBoundingBoxes)
+      .SetMinimumBoundingBoxSize(0.0f)
+      .SetResizeThreshold(resize_threshold)
+      .SetSmoothingRect(false)
+      .Build();
+}
+
+clova::Frame ToFrame(const cv::Mat& mat) {
+  return clova::Frame(mat.data, mat.cols, mat.rows,
+                      clova::Frame::Format::kBGR_888);
+}
+
+cv::Rect ToCvRect(const clova::Rect& rect) {
+  return cv::Rect(rect.x(), rect.y(), rect.width(), rect.height());
+}
+
+std::vector<cv::Rect> ToCvRects(const clova::face::Result& result,
+                                const cv::Point& offset,
+                                const cv::Rect& bounds) {
+  std::vector<cv::Rect> boxes;
+  for (const auto& face : result.faces()) {
+    const auto& box = (ToCvRect(face.bounding_box()) + offset) & bounds;
+    if (!box.empty())
+      boxes.push_back(box);
+  }
+  return boxes;
+}
+
+// Returns the starts of |length| pixels split in tiles of |tile_size| that
+// advance by |stride|, the last of which ends exactly at |length|.
+std::vector<int> GetTileStarts(int length, int tile_size, int stride) {
+  std::vector<int> starts { 0 };
+  while (starts.back() + tile_size < length)
+    starts.push_back(std::min(starts.back() + stride, length - tile_size));
+  return starts;
+}
+
+}  // namespace
+
+TiledFaceDetector::TiledFaceDetector(int tile_size,
+                                     float overlap_ratio,
+                                     size_t number_of_instances)
+    : tile_size_(tile_size),
+      overlap_ratio_(overlap_ratio),
+      coarse_options_(NewOptions(320)),
+      tile_options_(NewOptions(tile_size)),
+      worker_pool_(std::max<size_t>(number_of_instances, 1)) {
+  const auto& settings = clova::SettingsBuilder()
+      .SetIntermittentInformationRatio(1)
+      .SetNumberOfThreads(1)
+      .Build();
+  number_of_instances = std::max<size_t>(number_of_instances, 1);
+  for (size_t index = 0; index < number_of_instances; ++index)
+    instances_.push_back(std::make_unique<clova::ClovaSee>(settings));
+  tile_buffers_.resize(number_of_instances);
+}
+
+TiledFaceDetector::~TiledFaceDetector() {
+}
+
+std::vector<cv::Rect> TiledFaceDetector::Detect(const cv::Mat& snapshot) {
+  if (std::max(snapshot.cols, snapshot.rows) <= tile_size_)
+    return DetectTiles(0, snapshot, {}, true);
+
+  // The coarse pass counts as the first pass, and pass i goes to instance
+  // i % N, so the coarse pass overlaps with the tiles of the other instances.
+  const auto& tiles = GetTiles(snapshot.size());
+  std::vector<std::vector<cv::Rect>> tiles_per_instance(instances_.size());
+  for (size_t index = 0; index < tiles.size(); ++index) {
+    tiles_per_instance[(index + 1) % instances_.size()].push_back(
+        tiles[index]);
+  }
+
+  std::vector<std::vector<cv::Rect>> boxes_per_instance(instances_.size());
+  std::vector<std::future<void>> futures;
+  for (size_t index = 0; index < instances_.size(); ++index) {
+    futures.push_back(worker_pool_.Submit([&, index] {
+      boxes_per_instance[index] = DetectTiles(
+          index, snapshot, tiles_per_instance[index], index == 0);
+    }));
+  }
+  // Every pass is over before the first error, if any, is rethrown, as the
+  // passes refer to the locals of this frame.
+  for (const auto& future : futures)
+    future.wait();
+
+  std::vector<cv::Rect> boxes;
+  for (size_t index = 0; index < instances_.size(); ++index) {
+    futures[index].get();
+    boxes.insert(boxes.end(), boxes_per_instance[index].cbegin(),
+                 boxes_per_instance[index].cend());
+  }
+  return Suppress(std::move(boxes));
+}
+
+std::vector<cv::Rect> TiledFaceDetector::GetTiles(const cv::Size& size) const {
+  const int tile_width = std::min(tile_size_, size.width);
+  const int tile_height = std::min(tile_size_, size.height);
+  const int stride = std::max<int>(tile_size_ * (1.0f - overlap_ratio_), 1);
+
+  std::vector<cv::Rect> tiles;
+  for (const auto y : GetTileStarts(size.height, tile_height, stride)) {
+    for (const auto x : GetTileStarts(size.width, tile_width, stride))
+      tiles.emplace_back(x, y, tile_width, tile_height);
+  }
+  return tiles;
+}
+
+std::vector<cv::Rect> TiledFaceDetector::DetectTiles(
+    size_t instance_index,
+    const cv::Mat& snapshot,
+    const std::vector<cv::Rect>& tiles,
+    bool includes_coarse_pass) {
+  const cv::Rect bounds(cv::Point(0, 0), snapshot.size());
+  auto& instance = *instances_[instance_index];
+  auto& tile_buffer = tile_buffers_[instance_index];
+
+  std::vector<cv::Rect> boxes;
+  if (includes_coarse_pass) {
+    boxes = ToCvRects(instance.Run(ToFrame(snapshot), coarse_options_),
+                      cv::Point(0, 0), bounds);
+  }
+  for (const auto& tile : tiles) {
+    // A Frame has no stride, so the tile is copied into a continuous buffer
+    // that is reused from frame to frame.
+    snapshot(tile).copyTo(tile_buffer);
+    const auto& tile_boxes = ToCvRects(
+        instance.Run(ToFrame(tile_buffer), tile_options_), tile.tl(), bounds);
+    boxes.insert(boxes.end(), tile_boxes.cbegin(), tile_boxes.cend());
+  }
+  return boxes;
+}
+
+std::vector<cv::Rect> TiledFaceDetector::Suppress(
+    std::vector<cv::Rect> boxes) {
+  std::sort(boxes.begin(), boxes.end(),
+            [](const cv::Rect& lhs, const cv::Rect& rhs) {
+              return lhs.area() > rhs.area();
+            });
+
+  std::vector<cv::Rect> kept_boxes;
+  for (const auto& box : boxes) {
+    const bool is_duplicate = std::any_of(
+        kept_boxes.cbegin(), kept_boxes.cend(),
+        [&box](const cv::Rect& kept_box) {
+          const float intersection = (box & kept_box).area();
+          const float iou =
+              intersection / (box.area() + kept_box.area() - intersection);
+          const float containment =
+              intersection / std::min(box.area(), kept_box.area());
+          return iou > kIouThreshold || containment > kContainmentThreshold;
+        });
+    if (!is_duplicate)
+      kept_boxes.push_back(box);
+  }
+  return kept_boxes;
+}
+
+}  // namespace example
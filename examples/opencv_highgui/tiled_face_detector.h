@@ -0,0 +1,69 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_TILED_FACE_DETECTOR_H_
+#define EXAMPLES_OPENCV_HIGHGUI_TILED_FACE_DETECTOR_H_
+
+#include <memory>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "base/settings.h"
+#include "face/options.h"
+#include "sdk/clova_see.h"
+#include "worker_pool.h"
+
+namespace example {
+
+// Detects faces in high-resolution frames, where shrinking the whole frame to
+// the detector input makes distant faces vanish.
+//
+// The frame is split into overlapping tiles that are detected at their native
+// scale, spread over a few single-threaded ClovaSee instances that run in
+// parallel on workers of their own. A coarse pass over the whole frame, taken
+// by the first instance alongside the tiles of the others, catches the faces
+// that are too large for a tile, and the boxes of all passes are merged by a
+// global NMS.
+class TiledFaceDetector {
+ public:
+  TiledFaceDetector(int tile_size,
+                    float overlap_ratio,
+                    size_t number_of_instances);
+  virtual ~TiledFaceDetector();
+
+  std::vector<cv::Rect> Detect(const cv::Mat& snapshot);
+
+ private:
+  std::vector<cv::Rect> GetTiles(const cv::Size& size) const;
+  std::vector<cv::Rect> DetectTiles(size_t instance_index,
+                                    const cv::Mat& snapshot,
+                                    const std::vector<cv::Rect>& tiles,
+                                    bool includes_coarse_pass);
+
+  static std::vector<cv::Rect> Suppress(std::vector<cv::Rect> boxes);
+
+  const int tile_size_;
+  const float overlap_ratio_;
+  const clova::face::Options coarse_options_;
+  const clova::face::Options tile_options_;
+  std::vector<std::unique_ptr<clova::ClovaSee>> instances_;
+  std::vector<cv::Mat> tile_buffers_;
+  WorkerPool worker_pool_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_TILED_FACE_DETECTOR_H_
@@ -0,0 +1,70 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace example {
+
+WorkerPool::WorkerPool(size_t number_of_workers)
+    : quit_requested_(false) {
+  number_of_workers = std::max<size_t>(number_of_workers, 1);
+  for (size_t index = 0; index < number_of_workers; ++index)
+    workers_.emplace_back(&WorkerPool::Work, this);
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_requested_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+std::future<void> WorkerPool::Submit(Task task) {
+  std::packaged_task<void()> packaged_task(std::move(task));
+  auto future = packaged_task.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(packaged_task));
+  }
+  condition_.notify_one();
+  return future;
+}
+
+void WorkerPool::Work() {
+  while (true) {
+    std::packaged_task<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this]() {
+        return quit_requested_ || !tasks_.empty();
+      });
+      // The queued tasks are run before quitting, so no future is left
+      // without a value.
+      if (tasks_.empty())
+        return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace example
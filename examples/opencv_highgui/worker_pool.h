@@ -0,0 +1,57 @@
+// CLOVA Face Kit
+// Copyright (c) 2021-present NAVER Corp.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EXAMPLES_OPENCV_HIGHGUI_WORKER_POOL_H_
+#define EXAMPLES_OPENCV_HIGHGUI_WORKER_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace example {
+
+// A fixed set of workers that lives as long as the pool, so that the work of
+// a frame is handed to threads started once instead of new ones per frame.
+// Tasks run in the order they are submitted, on whichever worker is idle.
+class WorkerPool {
+ public:
+  using Task = std::function<void()>;
+
+  explicit WorkerPool(size_t number_of_workers);
+  virtual ~WorkerPool();
+
+  // The returned future rethrows what |task| threw. A task must not wait for
+  // another task of the same pool, or it may hold the last idle worker.
+  std::future<void> Submit(Task task);
+
+  size_t number_of_workers() const { return workers_.size(); }
+
+ private:
+  void Work();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::packaged_task<void()>> tasks_;
+  bool quit_requested_;
+};
+
+}  // namespace example
+
+#endif  // EXAMPLES_OPENCV_HIGHGUI_WORKER_POOL_H_